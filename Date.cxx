@@ -26,44 +26,141 @@
 #include "String.hxx"
 #include "Date.hxx"
 
+#include <mutex>
+#include <unordered_map>
+
 namespace Talos
 {
 
-  //////////
-  // DATE //
-  //////////
+  ////////////////////////
+  // CALENDAR FUNCTIONS //
+  ////////////////////////
 
-  //! Default constructor.
-  Date::Date():
-    year_(0), month_(0), day_(0),
-    hour_(0), minutes_(0), seconds_(0),
-    month_lengths_(12)
+  //! Integer division rounded towards minus infinity.
+  /*!
+    \param numerator numerator.
+    \param denominator denominator (positive).
+    \return The largest integer lower than or equal to
+    'numerator' / 'denominator'.
+  */
+  constexpr int floor_div(int numerator, int denominator)
   {
-    int month_lengths[12] = {31, 28, 31, 30, 31, 30,
-                             31, 31, 30, 31, 30, 31
-    };
-    for (int i = 0; i < 12; ++i)
-      month_lengths_[i] = month_lengths[i];
+    return numerator >= 0 ? numerator / denominator
+      : (numerator - denominator + 1) / denominator;
+  }
 
-    this->Adjust();
+  //! Integer division rounded towards minus infinity.
+  /*!
+    \param numerator numerator.
+    \param denominator denominator (positive).
+    \return The largest integer lower than or equal to
+    'numerator' / 'denominator'.
+  */
+  constexpr long long floor_div(long long numerator, long long denominator)
+  {
+    return numerator >= 0 ? numerator / denominator
+      : (numerator - denominator + 1) / denominator;
   }
 
-  //! Copy constructor.
+  //! Returns the number of days from 1970-01-01 to a given date.
+  /*!
+    The proleptic Gregorian calendar is used for all years. The computation
+    is carried out in constant time, and it may be evaluated at compile
+    time.
+    \param year year.
+    \param month month (between 1 and 12).
+    \param day day. It may exceed the length of the month, in which case
+    the following days are counted.
+    \return The number of days from 1970-01-01 to the date.
+  */
+  constexpr int days_from_civil(int year, int month, int day)
+  {
+    // The year is taken from March, so that the leap day ends it. The day
+    // of this year is (153 * (month - 3) + 2) / 5 + day - 1, with the
+    // months counted from March.
+    return 365 * (month <= 2 ? year - 1 : year)
+      + floor_div(month <= 2 ? year - 1 : year, 4)
+      - floor_div(month <= 2 ? year - 1 : year, 100)
+      + floor_div(month <= 2 ? year - 1 : year, 400)
+      + (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1
+      - 719468;
+  }
+
+  //! Number of days in a year before each month, and in the whole year.
+  /*!
+    The first row is for common years, the second for leap years.
+  */
+  constexpr int cumulative_month_days_[2][13] =
+    {{0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334, 365},
+     {0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335, 366}};
+
+  //! Is a given year a leap year?
+  /*!
+    \param year year.
+    \return true if the year 'year' is a leap year, false otherwise.
+  */
+  constexpr bool is_leap_year(int year)
+  {
+    return year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+  }
+
+  //! Returns the ordinal number of a day in its year.
+  /*!
+    The number is read in a table of cumulative month lengths, and it may
+    be evaluated at compile time.
+    \param year year.
+    \param month month (between 1 and 12).
+    \param day day.
+    \return The ordinal number of the day in the year (between 1 and 366).
+  */
+  constexpr int ordinal_day(int year, int month, int day)
+  {
+    return cumulative_month_days_[is_leap_year(year)][month - 1] + day;
+  }
+
+  //! Returns the date a given number of days after 1970-01-01.
   /*!
-    \param date date to be copied.
+    \param days number of days since 1970-01-01.
+    \param year (output) year.
+    \param month (output) month.
+    \param day (output) day.
   */
-  Date::Date(const Date& date):
-    year_(date.GetYear()), month_(date.GetMonth()), day_(date.GetDay()),
-    hour_(date.GetHour()), minutes_(date.GetMinutes()),
-    seconds_(date.GetSeconds()), month_lengths_(12)
+  void civil_from_days(int days, int& year, int& month, int& day)
   {
-    int month_lengths[12] = {31, 28, 31, 30, 31, 30,
-                             31, 31, 30, 31, 30, 31
-    };
-    for (int i = 0; i < 12; ++i)
-      month_lengths_[i] = month_lengths[i];
+    days += 719468;
+    int era = (days >= 0 ? days : days - 146096) / 146097;
+    int day_of_era = days - era * 146097;
+    int year_of_era = (day_of_era - day_of_era / 1460 + day_of_era / 36524
+                       - day_of_era / 146096) / 365;
+    int day_of_year = day_of_era
+      - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+    int shifted_month = (5 * day_of_year + 2) / 153;
+    day = day_of_year - (153 * shifted_month + 2) / 5 + 1;
+    month = shifted_month < 10 ? shifted_month + 3 : shifted_month - 9;
+    year = year_of_era + era * 400 + (month <= 2 ? 1 : 0);
+  }
+
+  //! Returns the week day of a given number of days after 1970-01-01.
+  /*!
+    \param days number of days since 1970-01-01.
+    \return The week day number: 0 for Monday, 1 for Tuesday, ..., 6 for
+    Sunday.
+  */
+  constexpr int week_day_from_days(int days)
+  {
+    // 1st January 1970 is a Thursday.
+    return (days % 7 + 10) % 7;
+  }
 
-    this->Adjust();
+
+  //////////
+  // DATE //
+  //////////
+
+  //! Default constructor.
+  Date::Date()
+  {
+    this->Adjust(0, 0, 0, 0, 0, 0.);
   }
 
   //! Copy constructor.
@@ -72,14 +169,8 @@ namespace Talos
     YYYYMMDDHHMM or YYYYMMDDHHMMSS, with each item (YYYY, MM, DD, etc.)
     possibly delimited with any character(s).
   */
-  Date::Date(string date): month_lengths_(12)
+  Date::Date(const string& date)
   {
-    int month_lengths[12] = {31, 28, 31, 30, 31, 30,
-                             31, 31, 30, 31, 30, 31
-    };
-    for (int i = 0; i < 12; ++i)
-      month_lengths_[i] = month_lengths[i];
-
     this->SetDate(date);
   }
 
@@ -87,21 +178,9 @@ namespace Talos
   /*!
     \param yyyymmdd date in format YYYYMMDD.
   */
-  Date::Date(int yyyymmdd):
-    hour_(0), minutes_(0), seconds_(0),
-    month_lengths_(12)
+  Date::Date(int yyyymmdd)
   {
-    year_ = yyyymmdd / 10000;
-    month_ = (yyyymmdd % 10000) / 100;
-    day_ = yyyymmdd % 100;
-
-    int month_lengths[12] = {31, 28, 31, 30, 31, 30,
-                             31, 31, 30, 31, 30, 31
-    };
-    for (int i = 0; i < 12; ++i)
-      month_lengths_[i] = month_lengths[i];
-
-    this->Adjust();
+    this->SetDate(yyyymmdd);
   }
 
   //! Constructor.
@@ -114,36 +193,9 @@ namespace Talos
     \param sc seconds.
   */
   Date::Date(int yyyy, int mm, int dd,
-             int hh, int mn, double sc):
-    year_(yyyy), month_(mm), day_(dd),
-    hour_(hh), minutes_(mn), seconds_(sc),
-    month_lengths_(12)
+             int hh, int mn, double sc)
   {
-    int month_lengths[12] = {31, 28, 31, 30, 31, 30,
-                             31, 31, 30, 31, 30, 31
-    };
-    for (int i = 0; i < 12; ++i)
-      month_lengths_[i] = month_lengths[i];
-
-    this->Adjust();
-  }
-
-  //! Assignment operator.
-  /*!
-    \param date date to be copied.
-  */
-  Date& Date::operator=(const Date& date)
-  {
-    year_ = date.GetYear();
-    month_ = date.GetMonth();
-    day_ = date.GetDay();
-    hour_ = date.GetHour();
-    minutes_ = date.GetMinutes();
-    seconds_ = date.GetSeconds();
-
-    this->Adjust();
-
-    return *this;
+    this->Adjust(yyyy, mm, dd, hh, mn, sc);
   }
 
   //! Assignment operator.
@@ -152,7 +204,7 @@ namespace Talos
     YYYYMMDDHHMM or YYYYMMDDHHMMSS, with each item (YYYY, MM, DD, etc.)
     possibly delimited with any character(s).
   */
-  Date& Date::operator=(string date)
+  Date& Date::operator=(const string& date)
   {
     SetDate(date);
 
@@ -165,15 +217,8 @@ namespace Talos
   */
   void Date::SetDate(int yyyymmdd)
   {
-    year_ = yyyymmdd / 10000;
-    month_ = (yyyymmdd % 10000) / 100;
-    day_ = yyyymmdd % 100;
-
-    hour_ = 0;
-    minutes_ = 0;
-    seconds_ = 0.;
-
-    this->Adjust();
+    this->Adjust(yyyymmdd / 10000, (yyyymmdd % 10000) / 100,
+                 yyyymmdd % 100, 0, 0, 0.);
   }
 
   //! Sets the date.
@@ -182,67 +227,13 @@ namespace Talos
     YYYYMMDDHHMM or YYYYMMDDHHMMSS, with each item (YYYY, MM, DD, etc.)
     possibly delimited with any character(s).
   */
-  void Date::SetDate(string date)
+  void Date::SetDate(const string& date)
   {
-    vector<string> split_date;
-    string item = "";
-    int code;
-    // Parses the string to split items.
-    for (unsigned int i = 0; i < date.size(); i++)
-      {
-        code = int(date[i]);
-        // If the current character is an integer.
-        if (code > 47 && code < 58)
-          item += date[i];
-        else if (!item.empty())
-          {
-            split_date.push_back(item);
-            item = "";
-          }
-      }
-    if (!item.empty())
-      split_date.push_back(item);
-
-    // Checks that the date can be parsed.
-    string compressed_date;
-    if (split_date.size() == 0)
-      throw string("Badly formatted date: \"") + date + string("\".");
-    if (split_date[0].size() < 4)
+    int status = this->Parse(date.data(), date.data() + date.size());
+    if (status == 1)
       throw string("Badly formatted date: \"") + date + string("\".");
-    for (unsigned int i = 0; i < split_date.size(); i++)
-      {
-        if (split_date[i].size() % 2 != 0 || !is_integer(split_date[i]))
-          throw string("Badly formatted date: \"") + date + string("\".");
-        compressed_date += split_date[i];
-      }
-
-    // Year is at least provided.
-    year_ = to_num<int>(compressed_date.substr(0, 4));
-
-    // Initialization (in case the date is not specified up to seconds).
-    month_ = 1;
-    day_ = 1;
-    hour_ = 0;
-    minutes_ = 0;
-    seconds_ = 0.;
-
-    // Retrieves all information.
-    unsigned int length = compressed_date.size();
-    if (length >= 6)
-      month_ = to_num<int>(compressed_date.substr(4, 2));
-    if (length >= 8)
-      day_ = to_num<int>(compressed_date.substr(6, 2));
-    if (length >= 10)
-      hour_ = to_num<int>(compressed_date.substr(8, 2));
-    if (length >= 12)
-      minutes_ = to_num<int>(compressed_date.substr(10, 2));
-    if (length >= 14)
-      seconds_ = to_num<double>(compressed_date.substr(12, 2));
-
-    if (!IsValid())
+    if (status == 2)
       throw string("Date \"") + date + string("\" is invalid.");
-
-    this->Adjust();
   }
 
   //! Sets the date.
@@ -257,122 +248,180 @@ namespace Talos
   void Date::SetDate(int yyyy, int mm, int dd,
                      int hh, int mn, double sc)
   {
-    year_ = yyyy;
-    month_ = mm;
-    day_ = dd;
-    hour_ = hh;
-    minutes_ = mn;
-    seconds_ = sc;
+    this->Adjust(yyyy, mm, dd, hh, mn, sc);
+  }
 
-    this->Adjust();
+  //! Sets the date, unless it cannot be parsed.
+  /*!
+    \param date  date in format YYYY, YYYYMM, YYYYMMDD, YYYYMMDDHH,
+    YYYYMMDDHHMM or YYYYMMDDHHMMSS, with each item (YYYY, MM, DD, etc.)
+    possibly delimited with any character(s).
+    \return True if the date was set, false if 'date' is badly formatted or
+    invalid, in which case the current date is left unchanged.
+  */
+  bool Date::TryParse(const string& date)
+  {
+    return this->Parse(date.data(), date.data() + date.size()) == 0;
   }
 
-  //! Adjusts month lengths according to the year.
-  void Date::LeapYearAdjust()
+  //! Sets the date, unless it cannot be parsed.
+  /*!
+    \param first pointer to the first character of the date, in the format
+    accepted by 'SetDate(string)'.
+    \param last pointer past the last character of the date.
+    \return True if the date was set, false if the date is badly formatted
+    or invalid, in which case the current date is left unchanged.
+  */
+  bool Date::TryParse(const char* first, const char* last)
   {
-    if (LeapYear())
-      month_lengths_[1] = 29;
-    else
-      month_lengths_[1] = 28;
+    return this->Parse(first, last) == 0;
   }
 
-  //! Checks whether a date is valid.
+  //! Parses a date and sets the current date to it.
   /*!
-    \return True is the current date is valid, false otherwise.
+    The date is read in a single pass, without memory allocation. Its items
+    are the sequences of digits, which should all have an even length, the
+    first one being made of at least four digits. Once concatenated, they
+    give the year, and possibly the month, the day, the hour, the minutes
+    and the seconds (two digits each).
+    \param first pointer to the first character of the date.
+    \param last pointer past the last character of the date.
+    \return 0 if the date was set, 1 if it is badly formatted, 2 if it is
+    invalid. The current date is only modified in the first case.
   */
-  bool Date::IsValid()
+  int Date::Parse(const char* first, const char* last)
   {
-    this->LeapYearAdjust();
+    // Year, month, day, hour, minutes and seconds. The month and the day
+    // are 1 if they are not specified.
+    int item[6] = {0, 0, 0, 0, 0, 0};
+    // Number of digits in the date, and in the current sequence.
+    int nb_digit = 0, length = 0;
+    for (const char* c = first; c != last; ++c)
+      if (*c >= '0' && *c <= '9')
+        {
+          if (nb_digit < 14)
+            {
+              int i = nb_digit < 4 ? 0 : (nb_digit - 2) / 2;
+              item[i] = 10 * item[i] + (*c - '0');
+            }
+          ++nb_digit;
+          ++length;
+        }
+      else if (length != 0)
+        {
+          if (length % 2 != 0 || (length == nb_digit && length < 4))
+            return 1;
+          length = 0;
+        }
+    if (length % 2 != 0 || (length == nb_digit && length < 4))
+      return 1;
+
+    if (nb_digit < 6)
+      item[1] = 1;
+    if (nb_digit < 8)
+      item[2] = 1;
+
+    if (!IsValid(item[0], item[1], item[2], item[4], double(item[5])))
+      return 2;
+
+    this->Adjust(item[0], item[1], item[2], item[3], item[4],
+                 double(item[5]));
+    return 0;
+  }
 
-    // Month.
-    return month_ > 0 && month_ < 13
-                  && day_ > 0 && day_ < month_lengths_[month_ - 1] + 1
-                            && minutes_ > -1 && minutes_ < 60
-                                               && seconds_ >= 0. && seconds_ < 60.;
+  //! Returns the number of days in a month.
+  /*!
+    \param year year.
+    \param month month (between 1 and 12).
+    \return The number of days in the month.
+  */
+  int Date::GetMonthLength(int year, int month) const
+  {
+    const int* cumulative = cumulative_month_days_[is_leap_year(year)];
+    return cumulative[month] - cumulative[month - 1];
   }
 
-  //! Adjusts the date to make it valid.
-  void Date::Adjust()
+  //! Checks whether a date is valid.
+  /*!
+    \param year year.
+    \param month month.
+    \param day day.
+    \param minutes minutes.
+    \param seconds seconds.
+    \return True is the date is valid, false otherwise.
+  */
+  bool Date::IsValid(int year, int month, int day,
+                     int minutes, double seconds) const
   {
-    // Minutes.
-    if (seconds_ >= 60.)
-      {
-        minutes_ += int(seconds_ / 60.);
-        seconds_ -= double(int(seconds_ / 60.)) * 60.;
-      }
-    if (seconds_ < 0.)
-      {
-        minutes_ += int(seconds_ / 60.) - 1;
-        seconds_ -= double(int(seconds_ / 60.) - 1) * 60.;
-        if (seconds_ == 60.)
-          {
-            minutes_ += 1;
-            seconds_ = 0.;
-          }
-      }
+    return month > 0 && month < 13
+      && day > 0 && day < GetMonthLength(year, month) + 1
+      && minutes > -1 && minutes < 60
+      && seconds >= 0. && seconds < 60.;
+  }
 
-    // Hours.
-    if (minutes_ > 59)
-      {
-        hour_ += minutes_ / 60;
-        minutes_ = minutes_ % 60;
-      }
-    else if (minutes_ < 0)
-      {
-        hour_ += (minutes_ + 1) / 60 - 1;
-        minutes_ = 59 + (minutes_ + 1) % 60;
-      }
+  //! Adjusts a date to make it valid, and sets the current date to it.
+  /*!
+    The adjustment is carried out in constant time, whatever the number of
+    days, hours, minutes or seconds in excess.
+    \param year year.
+    \param month month.
+    \param day day.
+    \param hour hour.
+    \param minutes minutes.
+    \param seconds seconds.
+  */
+  void Date::Adjust(int year, int month, int day,
+                    int hour, int minutes, double seconds)
+  {
+    // Months.
+    int nb_yy = floor_div(month - 1, 12);
+    year += nb_yy;
+    month -= 12 * nb_yy;
 
-    // Days.
-    if (hour_ > 23)
-      {
-        day_ += hour_ / 24;
-        hour_ = hour_ % 24;
-      }
-    else if (hour_ < 0)
-      {
-        day_ += hour_ / 24 - 1;
-        hour_ = 24 + hour_ % 24;
-      }
+    // The days in excess are carried over to the following months.
+    days_ = days_from_civil(year, month, 1) + day - 1;
+    minutes_ = 0;
+    seconds_ = 0.;
 
-    // Months.
-    if (month_ > 12)
-      {
-        year_ += month_ / 12;
-        month_ = month_ % 12;
-      }
-    else if (month_ <= 0)
-      {
-        year_ += month_ / 12 - 1;
-        month_ = 12 + month_ % 12;
-      }
-    this->LeapYearAdjust();
+    this->AddTime(60LL * hour + minutes, seconds);
+  }
+
+  //! Adds minutes and seconds to the current date.
+  /*!
+    The minutes and the seconds in excess are carried over to the following
+    days in constant time.
+    \param minutes number of minutes.
+    \param seconds number of seconds.
+  */
+  void Date::AddTime(long long minutes, double seconds)
+  {
+    minutes += minutes_;
+    seconds += seconds_;
 
-    // Months again.
-    while (day_ > month_lengths_[month_ - 1])
+    // Minutes.
+    if (seconds >= 60.)
       {
-        day_ -= month_lengths_[month_ - 1];
-        ++month_;
-        if (month_ == 13)
-          {
-            month_ = 1;
-            ++year_;
-            this->LeapYearAdjust();
-          }
+        double nb_mn = floor(seconds / 60.);
+        minutes += (long long)nb_mn;
+        seconds -= nb_mn * 60.;
       }
-
-    while (day_ <= 0)
+    if (seconds < 0.)
       {
-        --month_;
-        if (month_ == 0)
+        double nb_mn = ceil(seconds / 60.) - 1.;
+        minutes += (long long)nb_mn;
+        seconds -= nb_mn * 60.;
+        if (seconds == 60.)
           {
-            month_ = 12;
-            --year_;
-            this->LeapYearAdjust();
+            minutes += 1;
+            seconds = 0.;
           }
-        day_ += month_lengths_[month_ - 1];
       }
 
+    // Days.
+    long long nb_dd = floor_div(minutes, 1440LL);
+    days_ += int(nb_dd);
+    minutes_ = int(minutes - 1440LL * nb_dd);
+    seconds_ = seconds;
   }
 
   //! Is a given year a leap year?
@@ -382,8 +431,7 @@ namespace Talos
   */
   bool Date::LeapYear(int year) const
   {
-    return (year % 4 == 0
-            && (year % 100 != 0 || year % 400 == 0));
+    return is_leap_year(year);
   }
 
   //! Is the current year a leap year?
@@ -392,7 +440,7 @@ namespace Talos
   */
   bool Date::LeapYear() const
   {
-    return this->LeapYear(year_);
+    return this->LeapYear(this->GetYear());
   }
 
   //! Returns the date in format YYYYMMDD.
@@ -401,7 +449,9 @@ namespace Talos
   */
   int Date::GetDate() const
   {
-    return year_ * 10000 + month_ * 100 + day_;
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    return year * 10000 + month * 100 + day;
   }
 
   //! Returns the date in a given format.
@@ -414,41 +464,10 @@ namespace Talos
   */
   string Date::GetDate(const string& format) const
   {
-    string output("");
-    string::size_type index_b(0), index_e, tmp;
-
-    while ((index_b != string::npos)
-           && (index_b < format.size()))
-      {
-        tmp = format.substr(index_b).find_first_of("%");
-        index_e = tmp == string::npos ? string::npos : index_b + tmp;
-        if ((index_e != string::npos) && (index_e != format.size() - 1))
-          {
-            output += format.substr(index_b, index_e - index_b);
-            if (format[index_e + 1] == 'y')
-              output += to_str_fill(year_, 4, '0', ostringstream::right);
-            else if (format[index_e + 1] == 'm')
-              output += to_str_fill(month_, 2, '0', ostringstream::right);
-            else if (format[index_e + 1] == 'd')
-              output += to_str_fill(day_, 2, '0', ostringstream::right);
-            else if (format[index_e + 1] == 'h')
-              output += to_str_fill(hour_, 2, '0', ostringstream::right);
-            else if (format[index_e + 1] == 'i')
-              output += to_str_fill(minutes_, 2, '0', ostringstream::right);
-            else if (format[index_e + 1] == 's')
-              output += to_str_fill(seconds_, 2, '0', ostringstream::right);
-            else
-              output += format.substr(index_e, 2);
-            index_b = index_e + 2;
-          }
-        else
-          {
-            output += format.substr(index_b);
-            index_b = string::npos;
-          }
-      }
-
-    return output;
+    const DateFormat* compiled = DateFormat::Get(format);
+    if (compiled != NULL)
+      return compiled->Render(*this);
+    return DateFormat(format).Render(*this);
   }
 
   //! Returns the date in a given format.
@@ -471,7 +490,9 @@ namespace Talos
   */
   int Date::GetYear() const
   {
-    return year_;
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    return year;
   }
 
   //! Returns the month.
@@ -480,7 +501,9 @@ namespace Talos
   */
   int Date::GetMonth() const
   {
-    return month_;
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    return month;
   }
 
   //! Returns the day.
@@ -489,7 +512,9 @@ namespace Talos
   */
   int Date::GetDay() const
   {
-    return day_;
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    return day;
   }
 
   //! Returns the hour.
@@ -498,7 +523,7 @@ namespace Talos
   */
   int Date::GetHour() const
   {
-    return hour_;
+    return minutes_ / 60;
   }
 
   //! Returns the minutes.
@@ -507,7 +532,7 @@ namespace Talos
   */
   int Date::GetMinutes() const
   {
-    return minutes_;
+    return minutes_ % 60;
   }
 
   //! Returns the seconds.
@@ -525,8 +550,10 @@ namespace Talos
   */
   void Date::AddYears(int nb_yy)
   {
-    year_ += nb_yy;
-    this->Adjust();
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    this->Adjust(year + nb_yy, month, day,
+                 minutes_ / 60, minutes_ % 60, seconds_);
   }
 
   //! Adds months to the current date.
@@ -535,8 +562,10 @@ namespace Talos
   */
   void Date::AddMonths(int nb_mm)
   {
-    month_ += nb_mm;
-    this->Adjust();
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    this->Adjust(year, month + nb_mm, day,
+                 minutes_ / 60, minutes_ % 60, seconds_);
   }
 
   //! Adds days to the current date.
@@ -545,8 +574,7 @@ namespace Talos
   */
   void Date::AddDays(int nb_dd)
   {
-    day_ += nb_dd;
-    this->Adjust();
+    days_ += nb_dd;
   }
 
   //! Adds hours to the current date.
@@ -555,8 +583,7 @@ namespace Talos
   */
   void Date::AddHours(int nb_hh)
   {
-    hour_ += nb_hh;
-    this->Adjust();
+    this->AddTime(60LL * nb_hh, 0.);
   }
 
   //! Adds minutes to the current date.
@@ -565,8 +592,7 @@ namespace Talos
   */
   void Date::AddMinutes(int nb_mn)
   {
-    minutes_ += nb_mn;
-    this->Adjust();
+    this->AddTime(nb_mn, 0.);
   }
 
   //! Adds seconds to the current date.
@@ -575,8 +601,7 @@ namespace Talos
   */
   void Date::AddSeconds(double nb_sc)
   {
-    seconds_ += nb_sc;
-    this->Adjust();
+    this->AddTime(0, nb_sc);
   }
 
   //! Sets the year.
@@ -585,8 +610,9 @@ namespace Talos
   */
   void Date::SetYear(int yyyy)
   {
-    year_ = yyyy;
-    this->Adjust();
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    this->Adjust(yyyy, month, day, minutes_ / 60, minutes_ % 60, seconds_);
   }
 
   //! Sets the month.
@@ -595,8 +621,9 @@ namespace Talos
   */
   void Date::SetMonth(int mm)
   {
-    month_ = mm;
-    this->Adjust();
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    this->Adjust(year, mm, day, minutes_ / 60, minutes_ % 60, seconds_);
   }
 
   //! Sets the day.
@@ -605,8 +632,9 @@ namespace Talos
   */
   void Date::SetDay(int dd)
   {
-    day_ = dd;
-    this->Adjust();
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    this->Adjust(year, month, dd, minutes_ / 60, minutes_ % 60, seconds_);
   }
 
   //! Sets the hour.
@@ -615,8 +643,9 @@ namespace Talos
   */
   void Date::SetHour(int hh)
   {
-    hour_ = hh;
-    this->Adjust();
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    this->Adjust(year, month, day, hh, minutes_ % 60, seconds_);
   }
 
   //! Sets the minutes.
@@ -625,8 +654,9 @@ namespace Talos
   */
   void Date::SetMinutes(int mn)
   {
-    minutes_ = mn;
-    this->Adjust();
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    this->Adjust(year, month, day, minutes_ / 60, mn, seconds_);
   }
 
   //! Sets the seconds.
@@ -635,8 +665,72 @@ namespace Talos
   */
   void Date::SetSeconds(double sc)
   {
-    seconds_ = sc;
-    this->Adjust();
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    this->Adjust(year, month, day, minutes_ / 60, minutes_ % 60, sc);
+  }
+
+  //! Returns the number of microseconds since 1970-01-01 00:00.
+  /*!
+    The ticks are exact integers: they may be compared, stored or
+    accumulated without any rounding error. They also provide a 64-bit key
+    that is sorted as the dates.
+    \return The number of microseconds since 1970-01-01 00:00, with the
+    seconds rounded to the nearest microsecond.
+  */
+  long long Date::GetTicks() const
+  {
+    return 86400000000LL * days_ + 60000000LL * minutes_
+      + llround(seconds_ * 1.e6);
+  }
+
+  //! Sets the date from a number of microseconds since 1970-01-01 00:00.
+  /*!
+    \param ticks number of microseconds since 1970-01-01 00:00.
+  */
+  void Date::SetTicks(long long ticks)
+  {
+    long long nb_dd = floor_div(ticks, 86400000000LL);
+    ticks -= 86400000000LL * nb_dd;
+    days_ = int(nb_dd);
+    minutes_ = int(ticks / 60000000LL);
+    seconds_ = double(ticks % 60000000LL) / 1.e6;
+  }
+
+  //! Adds microseconds to the current date.
+  /*!
+    The date is first rounded to the nearest microsecond. The additions are
+    carried out on integers, so that a date advanced by a series of small
+    time steps does not drift, contrary to 'AddSeconds'.
+    \param ticks number of microseconds.
+  */
+  void Date::AddTicks(long long ticks)
+  {
+    this->SetTicks(this->GetTicks() + ticks);
+  }
+
+  //! Returns the number of microseconds from a given date.
+  /*!
+    \param date the reference date.
+    \return The number of microseconds between 'date' and the current date
+    (positive if the current date is greater than 'date'), both dates being
+    rounded to the nearest microsecond.
+  */
+  long long Date::GetTicksFrom(const Date& date) const
+  {
+    return this->GetTicks() - date.GetTicks();
+  }
+
+  //! Returns a hash value of the date.
+  /*!
+    \return A hash value of the date. Equal dates have the same hash value.
+  */
+  size_t Date::GetHash() const
+  {
+    size_t hash_minutes = hash<long long>()(1440LL * days_ + minutes_);
+    size_t hash_seconds = hash<double>()(seconds_);
+    return hash_minutes ^ (hash_seconds + 0x9e3779b9 + (hash_minutes << 6)
+                           + (hash_minutes >> 2));
   }
 
   //! Returns the ordinal number of the day in the year (between 1 and 366).
@@ -646,7 +740,9 @@ namespace Talos
   */
   int Date::GetOrdinalDay() const
   {
-    return this->GetNumberOfDays() + 1;
+    int year, month, day;
+    civil_from_days(days_, year, month, day);
+    return ordinal_day(year, month, day);
   }
 
   //! Returns the number of the day in the year (between 0 and 365).
@@ -655,7 +751,7 @@ namespace Talos
   */
   int Date::GetDayNumber() const
   {
-    return this->GetNumberOfDays();
+    return this->GetOrdinalDay() - 1;
   }
 
   //! Returns the number of days in the year before the current day.
@@ -665,10 +761,7 @@ namespace Talos
   */
   int Date::GetNumberOfDays() const
   {
-    int res(0);
-    for (int i = 1; i < month_; i++)
-      res += month_lengths_[i - 1];
-    return res + day_ - 1;
+    return this->GetOrdinalDay() - 1;
   }
 
   //! Returns the number of days from a given date.
@@ -677,18 +770,9 @@ namespace Talos
     \return The number of days between 'date' and the current date
     (positive if the current date is greater than 'date').
   */
-  int Date::GetDaysFrom(Date date) const
+  int Date::GetDaysFrom(const Date& date) const
   {
-    int min_year = min(year_, date.GetYear());
-    int nb_days(0), nb_days_date(0);
-    for (int i = min_year; i < year_; i++)
-      nb_days += this->LeapYear(i) ? 366 : 365;
-    nb_days += this->GetDayNumber();
-    for (int i = min_year; i < date.GetYear(); i++)
-      nb_days_date += this->LeapYear(i) ? 366 : 365;
-    nb_days_date += date.GetDayNumber();
-
-    return nb_days - nb_days_date;
+    return days_ - date.days_;
   }
 
   //! Returns the number of seconds from a given date.
@@ -697,21 +781,11 @@ namespace Talos
     \return The number of seconds between 'date' and the current date
     (positive if the current date is greater than 'date').
   */
-  double Date::GetSecondsFrom(Date date) const
+  double Date::GetSecondsFrom(const Date& date) const
   {
-    int min_year = min(year_, date.GetYear());
-    int nb_days(0), nb_days_date(0);
-    for (int i = min_year; i < year_; i++)
-      nb_days += this->LeapYear(i) ? 366 : 365;
-    nb_days += this->GetDayNumber();
-    for (int i = min_year; i < date.GetYear(); i++)
-      nb_days_date += this->LeapYear(i) ? 366 : 365;
-    nb_days_date += date.GetDayNumber();
-
-    return 86400. * double(nb_days - nb_days_date)
-      + 3600. * double(hour_ - date.GetHour())
-      + 60. * double(minutes_ - date.GetMinutes())
-      + double(seconds_ - date.GetSeconds());
+    return 86400. * double(days_ - date.days_)
+      + 60. * double(minutes_ - date.minutes_)
+      + double(seconds_ - date.seconds_);
   }
 
   //! Returns the number of hours in the year before the current date.
@@ -720,7 +794,7 @@ namespace Talos
   */
   int Date::GetNumberOfHours() const
   {
-    return this->GetNumberOfDays() * 24 + hour_;
+    return this->GetNumberOfDays() * 24 + minutes_ / 60;
   }
 
   //! Returns the number of minutes in the year before the current date.
@@ -729,7 +803,7 @@ namespace Talos
   */
   int Date::GetNumberOfMinutes() const
   {
-    return this->GetNumberOfHours() * 60 + minutes_;
+    return this->GetNumberOfDays() * 1440 + minutes_;
   }
 
   //! Returns the number of seconds in the year before the current date.
@@ -754,15 +828,7 @@ namespace Talos
   */
   int Date::GetWeekDay() const
   {
-    // 1st January 1900 is a Monday.
-    // Unknown before.
-    if (year_ < 1900)
-      return 0;
-    int day = 0;
-    for (int year = 1900; year < year_; year++)
-      day += LeapYear(year) ? 366 : 365;
-    day += GetNumberOfDays();
-    return day % 7;
+    return week_day_from_days(days_);
   }
 
   ///////////////
@@ -777,7 +843,11 @@ namespace Talos
   */
   bool operator < (const Date& first_date, const Date& second_date)
   {
-    return first_date.GetSecondsFrom(second_date) < 0.;
+    if (first_date.days_ != second_date.days_)
+      return first_date.days_ < second_date.days_;
+    if (first_date.minutes_ != second_date.minutes_)
+      return first_date.minutes_ < second_date.minutes_;
+    return first_date.seconds_ < second_date.seconds_;
   }
 
   //! Comparison operator <=.
@@ -788,7 +858,7 @@ namespace Talos
   */
   bool operator <= (const Date& first_date, const Date& second_date)
   {
-    return first_date.GetSecondsFrom(second_date) <= 0.;
+    return !(second_date < first_date);
   }
 
   //! Comparison operator >.
@@ -799,7 +869,7 @@ namespace Talos
   */
   bool operator > (const Date& first_date, const Date& second_date)
   {
-    return first_date.GetSecondsFrom(second_date) > 0.;
+    return second_date < first_date;
   }
 
   //! Comparison operator >=.
@@ -810,7 +880,7 @@ namespace Talos
   */
   bool operator >= (const Date& first_date, const Date& second_date)
   {
-    return first_date.GetSecondsFrom(second_date) >= 0.;
+    return !(first_date < second_date);
   }
 
   //! Comparison operator ==.
@@ -821,7 +891,9 @@ namespace Talos
   */
   bool operator == (const Date& first_date, const Date& second_date)
   {
-    return first_date.GetSecondsFrom(second_date) == 0.;
+    return first_date.days_ == second_date.days_
+      && first_date.minutes_ == second_date.minutes_
+      && first_date.seconds_ == second_date.seconds_;
   }
 
   //! Comparison operator !=.
@@ -832,7 +904,7 @@ namespace Talos
   */
   bool operator != (const Date& first_date, const Date& second_date)
   {
-    return first_date.GetSecondsFrom(second_date) != 0.;
+    return !(first_date == second_date);
   }
 
   //! Redirection operator <<.
@@ -847,8 +919,805 @@ namespace Talos
     return out;
   }
 
+
+  ////////////////
+  // DATEFORMAT //
+  ////////////////
+
+
+  //! Default constructor.
+  /*!
+    The format is empty.
+  */
+  DateFormat::DateFormat():
+    literal_(1)
+  {
+  }
+
+  //! Main constructor.
+  /*!
+    \param format format. Special sequences are %y, %m, %d, %h, %i, %s for
+    the year, the month, the day, the hour, the minutes and the seconds
+    respectively (see 'Date::GetDate').
+  */
+  DateFormat::DateFormat(const string& format)
+  {
+    SetFormat(format);
+  }
+
+  //! Sets the format.
+  /*!
+    \param format format. Special sequences are %y, %m, %d, %h, %i, %s for
+    the year, the month, the day, the hour, the minutes and the seconds
+    respectively (see 'Date::GetDate').
+  */
+  void DateFormat::SetFormat(const string& format)
+  {
+    format_ = format;
+    field_.clear();
+    literal_.clear();
+
+    string literal;
+    string::size_type index_b(0), index_e;
+    while (index_b < format.size())
+      {
+        index_e = format.find('%', index_b);
+        if (index_e != string::npos && index_e != format.size() - 1)
+          {
+            literal += format.substr(index_b, index_e - index_b);
+            char field = format[index_e + 1];
+            if (field == 'y' || field == 'm' || field == 'd'
+                || field == 'h' || field == 'i' || field == 's')
+              {
+                literal_.push_back(literal);
+                field_.push_back(field);
+                literal = "";
+              }
+            else
+              literal += format.substr(index_e, 2);
+            index_b = index_e + 2;
+          }
+        else
+          {
+            literal += format.substr(index_b);
+            index_b = string::npos;
+          }
+      }
+    literal_.push_back(literal);
+  }
+
+  //! Returns the format.
+  /*!
+    \return The format.
+  */
+  const string& DateFormat::GetFormat() const
+  {
+    return format_;
+  }
+
+  //! Returns the compiled format associated with a text.
+  /*!
+    The format is compiled at the first call for a given text, and then kept
+    until the end of the program. Only a limited number of formats are
+    kept: beyond, this method returns NULL.
+    \param format format.
+    \return The compiled format, or NULL if too many formats are already
+    kept.
+  */
+  const DateFormat* DateFormat::Get(const string& format)
+  {
+    static unordered_map<string, DateFormat> cache;
+    static std::mutex cache_mutex;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    unordered_map<string, DateFormat>::iterator it = cache.find(format);
+    if (it == cache.end())
+      {
+        if (cache.size() >= 64)
+          return NULL;
+        it = cache.insert(make_pair(format, DateFormat(format))).first;
+      }
+    return &it->second;
+  }
+
+  //! Converts a date to a string, in a buffer.
+  /*!
+    As with 'snprintf', at most 'size' - 1 characters are written, followed
+    by a null character.
+    \param date the date.
+    \param buffer (output) the date in the format.
+    \param size size of 'buffer'.
+    \return The length of the date in the format, which may be greater than
+    the number of characters written.
+  */
+  size_t DateFormat::Render(const Date& date, char* buffer, size_t size) const
+  {
+    int year, month, day;
+    civil_from_days(date.days_, year, month, day);
+
+    size_t position = 0;
+    for (unsigned int i = 0; i < field_.size(); i++)
+      {
+        position = Append(literal_[i].data(), literal_[i].size(),
+                          buffer, size, position);
+        switch (field_[i])
+          {
+          case 'y':
+            position = AppendInteger(year, 4, buffer, size, position);
+            break;
+          case 'm':
+            position = AppendInteger(month, 2, buffer, size, position);
+            break;
+          case 'd':
+            position = AppendInteger(day, 2, buffer, size, position);
+            break;
+          case 'h':
+            position = AppendInteger(date.minutes_ / 60, 2,
+                                     buffer, size, position);
+            break;
+          case 'i':
+            position = AppendInteger(date.minutes_ % 60, 2,
+                                     buffer, size, position);
+            break;
+          case 's':
+            if (date.seconds_ == double(int(date.seconds_)))
+              position = AppendInteger(int(date.seconds_), 2,
+                                       buffer, size, position);
+            else
+              {
+                string seconds = to_str_fill(date.seconds_, 2, '0',
+                                             ostringstream::right);
+                position = Append(seconds.data(), seconds.size(),
+                                  buffer, size, position);
+              }
+            break;
+          }
+      }
+    position = Append(literal_.back().data(), literal_.back().size(),
+                      buffer, size, position);
+
+    if (size > 0)
+      buffer[min(position, size - 1)] = '\0';
+    return position;
+  }
+
+  //! Converts a date to a string.
+  /*!
+    \param date the date.
+    \param output (output) the date in the format. Its memory is reused.
+  */
+  void DateFormat::Render(const Date& date, string& output) const
+  {
+    char buffer[256];
+    size_t length = Render(date, buffer, 256);
+    if (length < 256)
+      output.assign(buffer, length);
+    else
+      {
+        output.resize(length + 1);
+        Render(date, &output[0], length + 1);
+        output.resize(length);
+      }
+  }
+
+  //! Converts a date to a string.
+  /*!
+    \param date the date.
+    \return The date in the format.
+  */
+  string DateFormat::Render(const Date& date) const
+  {
+    string output;
+    Render(date, output);
+    return output;
+  }
+
+  //! Appends characters to a buffer.
+  /*!
+    \param str the characters.
+    \param length number of characters in 'str'.
+    \param buffer (output) the buffer.
+    \param size size of 'buffer'. The last character is kept for the null
+    character.
+    \param position position where the characters are appended.
+    \return The position after the characters.
+  */
+  size_t DateFormat::Append(const char* str, size_t length,
+                            char* buffer, size_t size, size_t position)
+  {
+    for (size_t i = 0; i < length; i++, position++)
+      if (position + 1 < size)
+        buffer[position] = str[i];
+    return position;
+  }
+
+  //! Appends an integer to a buffer, padded with zeros.
+  /*!
+    \param value the integer.
+    \param width minimum number of characters, the integer being padded with
+    zeros on the left (before the sign).
+    \param buffer (output) the buffer.
+    \param size size of 'buffer'. The last character is kept for the null
+    character.
+    \param position position where the integer is appended.
+    \return The position after the integer.
+  */
+  size_t DateFormat::AppendInteger(int value, int width,
+                                   char* buffer, size_t size,
+                                   size_t position)
+  {
+    // Digits in reverse order, then the sign.
+    char digit[12];
+    int length = 0;
+    unsigned int magnitude = value < 0 ? 0u - unsigned(value)
+      : unsigned(value);
+    do
+      {
+        digit[length++] = char('0' + magnitude % 10);
+        magnitude /= 10;
+      }
+    while (magnitude != 0);
+    if (value < 0)
+      digit[length++] = '-';
+
+    for (; width > length; width--, position++)
+      if (position + 1 < size)
+        buffer[position] = '0';
+    for (; length > 0; position++)
+      {
+        --length;
+        if (position + 1 < size)
+          buffer[position] = digit[length];
+      }
+    return position;
+  }
+
+
+
+  //////////////
+  // TIMEAXIS //
+  //////////////
+
+
+  //! Default constructor.
+  /*!
+    The axis is empty, with a time step of one second.
+  */
+  TimeAxis::TimeAxis():
+    step_(1.), count_(0)
+  {
+  }
+
+  //! Main constructor.
+  /*!
+    \param start first date.
+    \param step time step in seconds (strictly positive).
+    \param count number of steps.
+  */
+  TimeAxis::TimeAxis(const Date& start, double step, int count)
+  {
+    Set(start, step, count);
+  }
+
+  //! Sets the axis.
+  /*!
+    \param start first date.
+    \param step time step in seconds (strictly positive).
+    \param count number of steps.
+  */
+  void TimeAxis::Set(const Date& start, double step, int count)
+  {
+    if (step <= 0.)
+      throw string("Error in TimeAxis::Set: the time step (") + to_str(step)
+        + ") should be strictly positive.";
+    if (count < 0)
+      throw string("Error in TimeAxis::Set: the number of steps (")
+        + to_str(count) + ") should be positive.";
+    start_ = start;
+    step_ = step;
+    count_ = count;
+  }
+
+  //! Returns the first date.
+  /*!
+    \return The first date.
+  */
+  const Date& TimeAxis::GetStart() const
+  {
+    return start_;
+  }
+
+  //! Returns the time step.
+  /*!
+    \return The time step in seconds.
+  */
+  double TimeAxis::GetStep() const
+  {
+    return step_;
+  }
+
+  //! Returns the number of steps.
+  /*!
+    \return The number of steps.
+  */
+  int TimeAxis::GetCount() const
+  {
+    return count_;
+  }
+
+  //! Returns the date of a step.
+  /*!
+    The date is computed from the first date, so that no error accumulates
+    along the axis.
+    \param index index of the step. It may be out of the axis.
+    \return The date of step 'index'.
+  */
+  Date TimeAxis::GetDate(int index) const
+  {
+    Date date(start_);
+    date.AddSeconds(double(index) * step_);
+    return date;
+  }
+
+  //! Returns the dates of all steps.
+  /*!
+    \param dates (output) the dates of the steps.
+  */
+  void TimeAxis::GetDates(vector<Date>& dates) const
+  {
+    dates.resize(count_);
+    if (count_ != 0)
+      GetDates(&dates[0]);
+  }
+
+  //! Returns the dates of all steps.
+  /*!
+    \param dates (output) array of at least 'GetCount()' elements, filled
+    with the dates of the steps.
+  */
+  void TimeAxis::GetDates(Date* dates) const
+  {
+    for (int i = 0; i < count_; i++)
+      dates[i] = GetDate(i);
+  }
+
+  //! Returns the numbers of seconds of all steps from a reference date.
+  /*!
+    \param reference the reference date.
+    \param seconds (output) the numbers of seconds between 'reference' and
+    the dates of the steps.
+  */
+  void TimeAxis::GetSeconds(const Date& reference,
+                            vector<double>& seconds) const
+  {
+    seconds.resize(count_);
+    if (count_ != 0)
+      GetSeconds(reference, &seconds[0]);
+  }
+
+  //! Returns the numbers of seconds of all steps from a reference date.
+  /*!
+    \param reference the reference date.
+    \param seconds (output) array of at least 'GetCount()' elements, filled
+    with the numbers of seconds between 'reference' and the dates of the
+    steps.
+  */
+  void TimeAxis::GetSeconds(const Date& reference, double* seconds) const
+  {
+    double offset = start_.GetSecondsFrom(reference);
+    for (int i = 0; i < count_; i++)
+      seconds[i] = offset + double(i) * step_;
+  }
+
+  //! Returns the position of a date on the axis.
+  /*!
+    \param date the date.
+    \return The number of time steps between the first date and 'date'.
+    It is not an integer if 'date' falls between two steps.
+  */
+  double TimeAxis::GetPosition(const Date& date) const
+  {
+    return date.GetSecondsFrom(start_) / step_;
+  }
+
+  //! Returns the index of the last step before a date.
+  /*!
+    A date within a millionth of a step after a step is considered to be
+    at this step.
+    \param date the date.
+    \return The index of the last step before or at 'date'. It is negative
+    if 'date' is before the first date, and it is greater than or equal to
+    'GetCount()' if 'date' is after the last step.
+  */
+  int TimeAxis::GetIndex(const Date& date) const
+  {
+    return int(floor(GetPosition(date) + 1.e-6));
+  }
+
+  //! Searches for the step at a given date.
+  /*!
+    A date within a millionth of a step of a step is considered to be at
+    this step.
+    \param date the date.
+    \return The index of the step at 'date', or -1 if no step is at 'date'.
+  */
+  int TimeAxis::Find(const Date& date) const
+  {
+    double position = GetPosition(date);
+    double index = floor(position + 0.5);
+    if (abs(position - index) > 1.e-6 || index < 0.
+        || index >= double(count_))
+      return -1;
+    return int(index);
+  }
+
+  //! Checks whether two axes share their steps.
+  /*!
+    \param axis the other axis.
+    \return True if both axes have the same time step and if the first date
+    of 'axis' is on the current axis (possibly extended beyond its ends),
+    false otherwise.
+  */
+  bool TimeAxis::IsAligned(const TimeAxis& axis) const
+  {
+    if (axis.step_ != step_)
+      return false;
+    double position = GetPosition(axis.start_);
+    return abs(position - floor(position + 0.5)) <= 1.e-6;
+  }
+
+  //! Returns the index of the first date of another axis.
+  /*!
+    \param axis the other axis, aligned with the current axis.
+    \return The index, on the current axis, of the first date of 'axis'.
+    It may be negative or greater than the number of steps.
+  */
+  int TimeAxis::GetOffset(const TimeAxis& axis) const
+  {
+    if (!IsAligned(axis))
+      throw string("Error in TimeAxis::GetOffset: the axes are not ")
+        + "aligned.";
+    return int(floor(GetPosition(axis.start_) + 0.5));
+  }
+
+  //! Returns the steps shared with another axis.
+  /*!
+    \param axis the other axis, aligned with the current axis.
+    \return The axis of the steps that are on both axes. It has no step if
+    the axes do not overlap.
+  */
+  TimeAxis TimeAxis::Intersect(const TimeAxis& axis) const
+  {
+    if (!IsAligned(axis))
+      throw string("Error in TimeAxis::Intersect: the axes are not ")
+        + "aligned.";
+    int offset = GetOffset(axis);
+    int first = max(0, offset);
+    int last = min(count_, offset + axis.count_);
+    if (last <= first)
+      return TimeAxis(start_, step_, 0);
+    return TimeAxis(GetDate(first), step_, last - first);
+  }
+
+
+
+  ///////////////////
+  // BATCH PARSING //
+  ///////////////////
+
+
+  //! Parses a date in a fixed-width format.
+  /*!
+    The supported formats are YYYYMMDD, YYYYMMDDHHMMSS, and YYYY-MM-DD,
+    YYYY-MM-DD_HH-II and YYYY-MM-DD_HH-II-SS with any non-digit characters
+    as delimiters. The digits are at fixed positions, so that no search is
+    needed.
+    \param begin beginning of the date.
+    \param length number of characters in the date.
+    \param seconds (output) the number of seconds from 1970-01-01 00:00 to
+    the date.
+    \return True if the date could be parsed, false if it is invalid or if
+    it is not in one of the supported formats.
+  */
+  bool parse_date_fixed(const char* begin, size_t length, long long& seconds)
+  {
+    bool delimited = length == 10 || length == 16 || length == 19;
+    if (!delimited && length != 8 && length != 14)
+      return false;
+
+    // Year, month, day, hour, minutes and seconds.
+    int item[6] = {0, 0, 0, 0, 0, 0};
+    // Non-zero if a digit is missing or if a delimiter is a digit.
+    unsigned int error = 0;
+    const char* c = begin;
+    const char* end = begin + length;
+    for (int i = 0; c != end; i++)
+      {
+        if (i != 0 && delimited)
+          error |= unsigned(*c++ - '0') <= 9;
+        for (int j = i == 0 ? 4 : 2; j > 0; j--, c++)
+          {
+            unsigned int digit = unsigned(*c - '0');
+            error |= digit > 9;
+            item[i] = 10 * item[i] + int(digit);
+          }
+      }
+    if (error != 0)
+      return false;
+
+    int year = item[0], month = item[1], day = item[2];
+    if (month < 1 || month > 12 || day < 1 || item[4] > 59 || item[5] > 59)
+      return false;
+    int days = days_from_civil(year, month, day);
+    // Beyond the 28th, the day should be before the next month.
+    if (day > 28 && days >= days_from_civil(month == 12 ? year + 1 : year,
+                                            month % 12 + 1, 1))
+      return false;
+
+    seconds = 86400LL * days + 3600LL * item[3] + 60LL * item[4] + item[5];
+    return true;
+  }
+
+  //! Parses a date, without exception.
+  /*!
+    \param begin beginning of the date, in the format accepted by
+    'Date::SetDate(string)'.
+    \param end end of the date.
+    \param seconds (output) the number of seconds from 1970-01-01 00:00 to
+    the date. It is left unchanged if the date could not be parsed.
+    \return True if the date could be parsed, false otherwise.
+  */
+  bool parse_date(const char* begin, const char* end, long long& seconds)
+  {
+    if (parse_date_fixed(begin, size_t(end - begin), seconds))
+      return true;
+
+    Date date;
+    if (!date.TryParse(begin, end))
+      return false;
+    static const Date epoch(1970, 1, 1);
+    seconds = 86400LL * date.GetDaysFrom(epoch)
+      + 60LL * (60 * date.GetHour() + date.GetMinutes())
+      + (long long)(date.GetSeconds());
+    return true;
+  }
+
+  //! Parses a range of dates.
+  /*!
+    Dates in fixed-width formats (such as YYYYMMDD or YYYY-MM-DD_HH-II-SS)
+    are parsed without any search. If OpenMP is enabled, large ranges are
+    parsed in parallel.
+    \param first first date, in the format accepted by
+    'Date::SetDate(string)'.
+    \param last pointer past the last date.
+    \param seconds (output) array of at least 'last - first' elements,
+    filled with the numbers of seconds from 1970-01-01 00:00 to the dates.
+    \warning An exception is thrown, as in 'Date::SetDate(string)', for the
+    first date that cannot be parsed.
+  */
+  void parse_dates(const string* first, const string* last,
+                   long long* seconds)
+  {
+    long long count = last - first;
+    // Index of the first date that could not be parsed.
+    long long error = count;
+#ifdef _OPENMP
+#pragma omp parallel for if (count >= 10000) reduction(min: error)
+#endif
+    for (long long i = 0; i < count; i++)
+      if (!parse_date(first[i].data(), first[i].data() + first[i].size(),
+                      seconds[i]) && i < error)
+        error = i;
+    if (error != count)
+      Date().SetDate(first[error]);
+  }
+
+  //! Parses a range of dates, keeping the days only.
+  /*!
+    If OpenMP is enabled, large ranges are parsed in parallel.
+    \param first first date, in the format accepted by
+    'Date::SetDate(string)'.
+    \param last pointer past the last date.
+    \param days (output) array of at least 'last - first' elements, filled
+    with the numbers of days from 1970-01-01 to the dates.
+    \warning An exception is thrown, as in 'Date::SetDate(string)', for the
+    first date that cannot be parsed.
+  */
+  void parse_dates(const string* first, const string* last, int* days)
+  {
+    long long count = last - first;
+    // Index of the first date that could not be parsed.
+    long long error = count;
+#ifdef _OPENMP
+#pragma omp parallel for if (count >= 10000) reduction(min: error)
+#endif
+    for (long long i = 0; i < count; i++)
+      {
+        long long seconds;
+        if (parse_date(first[i].data(), first[i].data() + first[i].size(),
+                       seconds))
+          days[i] = int(floor_div(seconds, 86400LL));
+        else if (i < error)
+          error = i;
+      }
+    if (error != count)
+      Date().SetDate(first[error]);
+  }
+
+  //! Parses the dates in a sequence of characters.
+  /*!
+    If OpenMP is enabled, large sequences are parsed in parallel.
+    \param first beginning of the characters.
+    \param last end of the characters.
+    \param delimiters the characters that delimit the dates.
+    \param seconds (output) the numbers of seconds from 1970-01-01 00:00 to
+    the dates.
+    \warning An exception is thrown, as in 'Date::SetDate(string)', for the
+    first date that cannot be parsed.
+  */
+  void parse_dates(const char* first, const char* last,
+                   const string& delimiters, vector<long long>& seconds)
+  {
+    bool is_delimiter[256] = {false};
+    for (unsigned int i = 0; i < delimiters.size(); i++)
+      is_delimiter[(unsigned char)(delimiters[i])] = true;
+
+    // Beginning and end of each date.
+    vector<const char*> date;
+    const char* c = first;
+    while (c != last)
+      {
+        while (c != last && is_delimiter[(unsigned char)(*c)])
+          ++c;
+        if (c == last)
+          break;
+        date.push_back(c);
+        while (c != last && !is_delimiter[(unsigned char)(*c)])
+          ++c;
+        date.push_back(c);
+      }
+
+    long long count = date.size() / 2;
+    seconds.resize(count);
+    // Index of the first date that could not be parsed.
+    long long error = count;
+#ifdef _OPENMP
+#pragma omp parallel for if (count >= 10000) reduction(min: error)
+#endif
+    for (long long i = 0; i < count; i++)
+      if (!parse_date(date[2 * i], date[2 * i + 1], seconds[i])
+          && i < error)
+        error = i;
+    if (error != count)
+      Date().SetDate(string(date[2 * error], date[2 * error + 1]));
+  }
+
+  //! Parses a vector of dates.
+  /*!
+    \param dates the dates, in the format accepted by
+    'Date::SetDate(string)'.
+    \param seconds (output) the numbers of seconds from 1970-01-01 00:00 to
+    the dates.
+    \warning An exception is thrown, as in 'Date::SetDate(string)', for the
+    first date that cannot be parsed.
+  */
+  void parse_dates(const vector<string>& dates, vector<long long>& seconds)
+  {
+    seconds.resize(dates.size());
+    if (!dates.empty())
+      parse_dates(&dates[0], &dates[0] + dates.size(), &seconds[0]);
+  }
+
+  //! Parses a vector of dates, keeping the days only.
+  /*!
+    \param dates the dates, in the format accepted by
+    'Date::SetDate(string)'.
+    \param days (output) the numbers of days from 1970-01-01 to the dates.
+    \warning An exception is thrown, as in 'Date::SetDate(string)', for the
+    first date that cannot be parsed.
+  */
+  void parse_dates(const vector<string>& dates, vector<int>& days)
+  {
+    days.resize(dates.size());
+    if (!dates.empty())
+      parse_dates(&dates[0], &dates[0] + dates.size(), &days[0]);
+  }
+
+  //! Parses the dates in a string.
+  /*!
+    \param buffer the string.
+    \param delimiters the characters that delimit the dates.
+    \param seconds (output) the numbers of seconds from 1970-01-01 00:00 to
+    the dates.
+    \warning An exception is thrown, as in 'Date::SetDate(string)', for the
+    first date that cannot be parsed.
+  */
+  void parse_dates(const string& buffer, const string& delimiters,
+                   vector<long long>& seconds)
+  {
+    parse_dates(buffer.data(), buffer.data() + buffer.size(), delimiters,
+                seconds);
+  }
+
+
+
+  //////////////////
+  // ORDINAL DAYS //
+  //////////////////
+
+
+  //! Computes the ordinal numbers of days given as days since 1970-01-01.
+  /*!
+    \param days array of 'count' numbers of days since 1970-01-01.
+    \param count number of days.
+    \param ordinal (output) array of at least 'count' elements, filled with
+    the ordinal numbers of the days in their years (between 1 and 366).
+  */
+  void get_ordinal_days(const int* days, int count, int* ordinal)
+  {
+    for (int i = 0; i < count; i++)
+      {
+        int year, month, day;
+        civil_from_days(days[i], year, month, day);
+        ordinal[i] = ordinal_day(year, month, day);
+      }
+  }
+
+  //! Computes the ordinal numbers of the days of dates.
+  /*!
+    \param dates array of 'count' dates.
+    \param count number of dates.
+    \param ordinal (output) array of at least 'count' elements, filled with
+    the ordinal numbers of the days of the dates (between 1 and 366).
+  */
+  void get_ordinal_days(const Date* dates, int count, int* ordinal)
+  {
+    for (int i = 0; i < count; i++)
+      ordinal[i] = dates[i].GetOrdinalDay();
+  }
+
+  //! Computes the ordinal numbers of days given as days since 1970-01-01.
+  /*!
+    \param days numbers of days since 1970-01-01.
+    \param ordinal (output) the ordinal numbers of the days in their years
+    (between 1 and 366).
+  */
+  void get_ordinal_days(const vector<int>& days, vector<int>& ordinal)
+  {
+    ordinal.resize(days.size());
+    if (!days.empty())
+      get_ordinal_days(&days[0], int(days.size()), &ordinal[0]);
+  }
+
+  //! Computes the ordinal numbers of the days of dates.
+  /*!
+    \param dates the dates.
+    \param ordinal (output) the ordinal numbers of the days of the dates
+    (between 1 and 366).
+  */
+  void get_ordinal_days(const vector<Date>& dates, vector<int>& ordinal)
+  {
+    ordinal.resize(dates.size());
+    if (!dates.empty())
+      get_ordinal_days(&dates[0], int(dates.size()), &ordinal[0]);
+  }
+
 }  // namespace Talos.
 
 
+namespace std
+{
+  //! Returns a hash value of a date.
+  /*!
+    \param date the date.
+    \return A hash value of the date.
+  */
+  size_t hash<Talos::Date>::operator() (const Talos::Date& date) const
+  {
+    return date.GetHash();
+  }
+}
+
+
 #define TALOS_FILE_DATE_CXX
 #endif
@@ -31,6 +31,8 @@
 #include <sstream>
 #include <vector>
 #include <stdexcept>
+#include <cmath>
+#include <functional>
 
 
 namespace Talos
@@ -38,45 +40,61 @@ namespace Talos
 
   using namespace std;
 
+#ifndef SWIG
+  constexpr int floor_div(int numerator, int denominator);
+  constexpr long long floor_div(long long numerator, long long denominator);
+  constexpr int days_from_civil(int year, int month, int day);
+  constexpr int week_day_from_days(int days);
+  constexpr bool is_leap_year(int year);
+  constexpr int ordinal_day(int year, int month, int day);
+  void civil_from_days(int days, int& year, int& month, int& day);
+#endif
+
+  class DateFormat;
+
+
   //! Class Date.
   class Date
   {
+    friend class DateFormat;
+    friend bool operator < (const Date& first_date, const Date& second_date);
+    friend bool operator == (const Date& first_date,
+                             const Date& second_date);
+
   private:
-    //! Year.
-    int year_;
-    //! Month.
-    int month_;
-    //! Day.
-    int day_;
-    //! Hour.
-    int hour_;
-    //! Minutes.
+    //! Number of days since 1970-01-01.
+    int days_;
+    //! Number of minutes since midnight.
     int minutes_;
     //! Seconds.
     double seconds_;
-    //! Month lengths;
-    vector<int> month_lengths_;
 
-    void LeapYearAdjust();
-    bool IsValid();
-    void Adjust();
+    int GetMonthLength(int year, int month) const;
+    bool IsValid(int year, int month, int day,
+                 int minutes, double seconds) const;
+    void Adjust(int year, int month, int day,
+                int hour, int minutes, double seconds);
+    void AddTime(long long minutes, double seconds);
+    int Parse(const char* first, const char* last);
 
   public:
     Date();
-    Date(const Date& date);
-    Date(string date);
+    Date(const string& date);
     Date(int yyyymmdd);
     Date(int yyyy, int mm, int dd = 1,
          int hh = 0, int mn = 0, double sc = 0);
 
 #ifndef SWIG
-    Date& operator=(const Date&);
-    Date& operator=(string date);
+    Date& operator=(const string& date);
 #endif
-    void SetDate(string date);
+    void SetDate(const string& date);
     void SetDate(int yyyymmdd);
     void SetDate(int yyyy, int mm, int dd = 1,
                  int hh = 0, int mn = 0, double sc = 0);
+    bool TryParse(const string& date);
+#ifndef SWIG
+    bool TryParse(const char* first, const char* last);
+#endif
 
     bool LeapYear(int year) const;
     bool LeapYear() const;
@@ -108,11 +126,18 @@ namespace Talos
     void SetMinutes(int mn);
     void SetSeconds(double sc);
 
+    long long GetTicks() const;
+    void SetTicks(long long ticks);
+    void AddTicks(long long ticks);
+    long long GetTicksFrom(const Date& date) const;
+
+    size_t GetHash() const;
+
     int GetOrdinalDay() const;
     int GetDayNumber() const;
     int GetNumberOfDays() const;
-    int GetDaysFrom(Date date) const;
-    double GetSecondsFrom(Date date) const;
+    int GetDaysFrom(const Date& date) const;
+    double GetSecondsFrom(const Date& date) const;
 
     int GetNumberOfHours() const;
     int GetNumberOfMinutes() const;
@@ -134,8 +159,128 @@ namespace Talos
   ostream& operator << (ostream& out, const Date& d);
 #endif
 
+
+  //! Date format compiled once, to convert many dates to strings.
+  /*!
+    The format is split into literal text and fields when the object is
+    built. A date is then rendered with integer-to-character conversions,
+    into a buffer provided by the caller.
+  */
+  class DateFormat
+  {
+  protected:
+    //! Format.
+    string format_;
+    //! Fields, that is, 'y', 'm', 'd', 'h', 'i' or 's'.
+    vector<char> field_;
+    //! Literal text before each field, and after the last field.
+    vector<string> literal_;
+
+  public:
+    DateFormat();
+    DateFormat(const string& format);
+
+    void SetFormat(const string& format);
+    const string& GetFormat() const;
+
+#ifndef SWIG
+    static const DateFormat* Get(const string& format);
+
+    size_t Render(const Date& date, char* buffer, size_t size) const;
+#endif
+    void Render(const Date& date, string& output) const;
+    string Render(const Date& date) const;
+
+  private:
+    static size_t Append(const char* str, size_t length,
+                         char* buffer, size_t size, size_t position);
+    static size_t AppendInteger(int value, int width,
+                                char* buffer, size_t size, size_t position);
+  };
+
+
+  //! Regular time axis.
+  /*!
+    The axis is made of 'count' dates, starting at a given date and
+    separated by a constant time step. The date of a step and the step of a
+    date are computed in constant time.
+  */
+  class TimeAxis
+  {
+  protected:
+    //! First date.
+    Date start_;
+    //! Time step in seconds.
+    double step_;
+    //! Number of steps.
+    int count_;
+
+  public:
+    TimeAxis();
+    TimeAxis(const Date& start, double step, int count);
+
+    void Set(const Date& start, double step, int count);
+
+    const Date& GetStart() const;
+    double GetStep() const;
+    int GetCount() const;
+
+    Date GetDate(int index) const;
+    void GetDates(vector<Date>& dates) const;
+#ifndef SWIG
+    void GetDates(Date* dates) const;
+#endif
+    void GetSeconds(const Date& reference, vector<double>& seconds) const;
+#ifndef SWIG
+    void GetSeconds(const Date& reference, double* seconds) const;
+#endif
+
+    double GetPosition(const Date& date) const;
+    int GetIndex(const Date& date) const;
+    int Find(const Date& date) const;
+
+    bool IsAligned(const TimeAxis& axis) const;
+    int GetOffset(const TimeAxis& axis) const;
+    TimeAxis Intersect(const TimeAxis& axis) const;
+  };
+
+
+#ifndef SWIG
+  bool parse_date(const char* begin, const char* end, long long& seconds);
+
+  void parse_dates(const string* first, const string* last,
+                   long long* seconds);
+  void parse_dates(const string* first, const string* last, int* days);
+  void parse_dates(const char* first, const char* last,
+                   const string& delimiters, vector<long long>& seconds);
+#endif
+  void parse_dates(const vector<string>& dates, vector<long long>& seconds);
+  void parse_dates(const vector<string>& dates, vector<int>& days);
+  void parse_dates(const string& buffer, const string& delimiters,
+                   vector<long long>& seconds);
+
+#ifndef SWIG
+  void get_ordinal_days(const int* days, int count, int* ordinal);
+  void get_ordinal_days(const Date* dates, int count, int* ordinal);
+#endif
+  void get_ordinal_days(const vector<int>& days, vector<int>& ordinal);
+  void get_ordinal_days(const vector<Date>& dates, vector<int>& ordinal);
+
 }  // namespace Talos.
 
 
+#ifndef SWIG
+namespace std
+{
+  //! Hash function of dates, for unordered containers.
+  template <>
+  struct hash<Talos::Date>
+  {
+    size_t operator() (const Talos::Date& date) const;
+  };
+}
+#endif
+
+
 #define TALOS_FILE_DATE_HXX
 #endif
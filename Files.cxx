@@ -28,7 +28,20 @@
 
 #include <algorithm>
 #include <map>
+#include <mutex>
 #include <set>
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/stat.h>
+#include <unistd.h>
+#if !defined(TALOS_DISABLE_MMAP)
+#define TALOS_MMAP
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
+#endif
 
 namespace Talos
 {
@@ -118,253 +131,346 @@ namespace Talos
     return res;
   }
 
-  //! Checks whether a numerical value satisfies a list of constraints.
+  ///////////////////
+  // CONSTRAINTSET //
+  ///////////////////
+
+  //! Main constructor.
   /*!
-    \param value the numerical value.
+    Parses a list of constraints. Invalid constraints are kept, so that an
+    exception is thrown only when they are reached, as if the list was
+    parsed along with the checks.
     \param constraint the list of constraints. The constraints are delimited
     by |. The supported constraints are: positive, strictly positive,
     negative, strictly negative, non zero, integer, > x, >= x, < x, <= x, != x
     y z, = x y z.
-    \return true if the constraints are satisfied, false otherwise.
   */
   template <class T>
-  bool satisfies_constraint(T value, string constraint)
+  ConstraintSet<T>::ConstraintSet(string constraint)
   {
     vector<string> constraint_list = split(constraint, "|");
 
     string expression, str;
-    T val;
+    int kind;
     for (int i = 0; i < int(constraint_list.size()); i++)
       {
         expression = trim(constraint_list[i]);
         if (expression.size() < 2)
-          throw "Error in satisfies_constraint: the constraint \""
-            + expression + "\" is not supported.";
-        if (expression[0] == '<')
+          kind = unsupported;
+        else if (expression[0] == '<')
           if (expression[1] == '=')
             {
+              kind = less_equal;
               str = trim(expression.substr(2));
-              if (!is_num(str))
-                throw "Error in satisfies_constraint: the constraint \""
-                  + expression + "\" cannot be parsed or is not supported.";
-              to_num(str, val);
-              if (value > val)
-                return false;
             }
           else
             {
+              kind = less;
               str = trim(expression.substr(1));
-              if (!is_num(str))
-                throw "Error in satisfies_constraint: the constraint \""
-                  + expression + "\" cannot be parsed or is not supported.";
-              to_num(str, val);
-              if (value >= val)
-                return false;
             }
         else if (expression[0] == '>')
           if (expression[1] == '=')
             {
+              kind = greater_equal;
               str = trim(expression.substr(2));
-              if (!is_num(str))
-                throw "Error in satisfies_constraint: the constraint \""
-                  + expression + "\" cannot be parsed or is not supported.";
-              to_num(str, val);
-              if (value < val)
-                return false;
             }
           else
             {
+              kind = greater;
               str = trim(expression.substr(1));
-              if (!is_num(str))
-                throw "Error in satisfies_constraint: the constraint \""
-                  + expression + "\" cannot be parsed or is not supported.";
-              to_num(str, val);
-              if (value <= val)
-                return false;
             }
         else if (expression.substr(0, 2) == "!=")
           {
+            kind = different;
             str = trim(expression.substr(2));
-            vector<string> number = split(str);
-            for (int j = 0; j < int(number.size()); j++)
-              {
-                if (!is_num(number[j]))
-                  throw "Error in satisfies_constraint: the constraint \""
-                    + expression + "\" cannot be parsed or is not supported.";
-                to_num(number[j], val);
-                if (value == val)
-                  return false;
-              }
           }
         else if (expression[0] == '=')
           {
+            kind = equal;
             str = trim(expression.substr(1));
-            vector<string> number = split(str);
-            bool acceptable = false;
-            for (int j = 0; j < int(number.size()); j++)
-              {
-                if (!is_num(number[j]))
-                  throw "Error in satisfies_constraint: the constraint \""
-                    + expression + "\" cannot be parsed or is not supported.";
-                to_num(number[j], val);
-                acceptable = acceptable || value == val;
-              }
-            if (!acceptable)
-              return false;
           }
         else if (expression == "positive")
+          kind = positive;
+        else if (expression == "strictly positive")
+          kind = strictly_positive;
+        else if (expression == "negative")
+          kind = negative;
+        else if (expression == "strictly negative")
+          kind = strictly_negative;
+        else if (expression == "non zero")
+          kind = non_zero;
+        else if (expression == "integer")
+          kind = integer;
+        else
+          kind = invalid;
+
+        vector<string> number;
+        if (kind == different || kind == equal)
+          number = split(str);
+        else if (kind == less_equal || kind == less || kind == greater_equal
+                 || kind == greater)
+          number.push_back(str);
+
+        vector<T> value(number.size());
+        int first_invalid = -1;
+        for (int j = 0; j < int(number.size()); j++)
+          if (!is_num(number[j], value[j]) && first_invalid == -1)
+            first_invalid = j;
+        if (first_invalid != -1 && kind != different && kind != equal)
+          kind = invalid;
+
+        kind_.push_back(kind);
+        expression_.push_back(expression);
+        number_str_.push_back(number);
+        number_.push_back(value);
+        invalid_.push_back(first_invalid);
+      }
+  }
+
+  //! Returns the list of constraints associated with a text.
+  /*!
+    The list is parsed at the first call for a given text, and then kept
+    until the end of the program. Only a limited number of lists are kept:
+    beyond, this method returns NULL.
+    \param constraint the list of constraints, as in the constructor.
+    \return The parsed list of constraints, or NULL if too many lists are
+    already kept.
+  */
+  template <class T>
+  const ConstraintSet<T>* ConstraintSet<T>::Get(const string& constraint)
+  {
+    static unordered_map<string, ConstraintSet<T> > cache;
+    static std::mutex cache_mutex;
+
+    std::lock_guard<std::mutex> lock(cache_mutex);
+    typename unordered_map<string, ConstraintSet<T> >::iterator it
+      = cache.find(constraint);
+    if (it == cache.end())
+      {
+        if (cache.size() >= 64)
+          return NULL;
+        it = cache.insert(make_pair(constraint,
+                                    ConstraintSet<T>(constraint))).first;
+      }
+    return &it->second;
+  }
+
+  //! Checks whether a numerical value satisfies the constraints.
+  /*!
+    \param value the numerical value.
+    \return true if the constraints are satisfied, false otherwise.
+  */
+  template <class T>
+  bool ConstraintSet<T>::Satisfies(T value) const
+  {
+    for (int i = 0; i < int(kind_.size()); i++)
+      {
+        const vector<T>& number = number_[i];
+        switch (kind_[i])
           {
+          case unsupported:
+            throw "Error in satisfies_constraint: the constraint \""
+              + expression_[i] + "\" is not supported.";
+          case invalid:
+            ThrowInvalid(i, "satisfies_constraint");
+            break;
+          case less_equal:
+            if (value > number[0])
+              return false;
+            break;
+          case less:
+            if (value >= number[0])
+              return false;
+            break;
+          case greater_equal:
+            if (value < number[0])
+              return false;
+            break;
+          case greater:
+            if (value <= number[0])
+              return false;
+            break;
+          case different:
+            for (int j = 0; j < int(number.size()); j++)
+              {
+                if (j == invalid_[i])
+                  ThrowInvalid(i, "satisfies_constraint");
+                if (value == number[j])
+                  return false;
+              }
+            break;
+          case equal:
+            {
+              if (invalid_[i] != -1)
+                ThrowInvalid(i, "satisfies_constraint");
+              bool acceptable = false;
+              for (int j = 0; j < int(number.size()); j++)
+                acceptable = acceptable || value == number[j];
+              if (!acceptable)
+                return false;
+              break;
+            }
+          case positive:
             if (value < T(0))
               return false;
-          }
-        else if (expression == "strictly positive")
-          {
+            break;
+          case strictly_positive:
             if (value <= T(0))
               return false;
-          }
-        else if (expression == "negative")
-          {
+            break;
+          case negative:
             if (value > T(0))
               return false;
-          }
-        else if (expression == "strictly negative")
-          {
+            break;
+          case strictly_negative:
             if (value >= T(0))
               return false;
-          }
-        else if (expression == "non zero")
-          {
+            break;
+          case non_zero:
             if (value == T(0))
               return false;
-          }
-        else if (expression == "integer")
-          {
+            break;
+          case integer:
             if (value != T(int(value)))
               return false;
+            break;
           }
-        else
-          throw "Error in satisfies_constraint: the constraint \""
-            + expression + "\" cannot be parsed or is not supported.";
       }
 
     return true;
   }
 
-  //! Formats a list of constraints in a string readable for human beings.
+  //! Formats the constraints in a string readable for human beings.
   /*!
-    \param constraint the list of constraints. The constraints are delimited
-    by |. The supported constraints are: positive, strictly positive,
-    negative, strictly negative, non zero, integer, > x, >= x, < x, <= x, != x
-    y z, = x y z.
     \return The constraints in a readable string.
   */
-  string show_constraint(string constraint)
+  template <class T>
+  string ConstraintSet<T>::Show() const
   {
-    vector<string> constraint_list = split(constraint, "|");
-
     string output = "";
 
-    string expression, str, termination;
-    for (int i = 0; i < int(constraint_list.size()); i++)
+    string termination;
+    for (int i = 0; i < int(kind_.size()); i++)
       {
-        if (i != int(constraint_list.size()) - 1)
+        if (i != int(kind_.size()) - 1)
           termination = ";\n";
         else
           termination = ".";
-        expression = trim(constraint_list[i]);
-        if (expression.size() < 2)
-          throw "Error in show_constraint: the constraint \""
-            + expression + "\" cannot be parsed.";
-        if (expression[0] == '<')
-          if (expression[1] == '=')
-            {
-              str = trim(expression.substr(2));
-              if (!is_num(str))
-                throw "Error in show_constraint: the constraint \""
-                  + expression + "\" cannot be parsed or is not supported.";
-              output += " - Value less than " + str + termination;
-            }
-          else
-            {
-              str = trim(expression.substr(1));
-              if (!is_num(str))
-                throw "Error in show_constraint: the constraint \""
-                  + expression + "\" cannot be parsed or is not supported.";
-              output += " - Value strictly less than " + str + termination;
-            }
-        else if (expression[0] == '>')
-          if (expression[1] == '=')
-            {
-              str = trim(expression.substr(2));
-              if (!is_num(str))
-                throw "Error in show_constraint: the constraint \""
-                  + expression + "\" cannot be parsed or is not supported.";
-              output += " - Value greater than " + str + termination;
-            }
-          else
-            {
-              str = trim(expression.substr(1));
-              if (!is_num(str))
-                throw "Error in show_constraint: the constraint \""
-                  + expression + "\" cannot be parsed or is not supported.";
-              output += " - Value strictly greater than " + str + termination;
-            }
-        else if (expression.substr(0, 2) == "!=")
-          {
-            str = trim(expression.substr(2));
-            vector<string> number = split(str);
-            output += " - Value different from ";
-            for (int j = 0; j < int(number.size()); j++)
-              {
-                if (!is_num(number[j]))
-                  throw "Error in show_constraint: the constraint \""
-                    + expression + "\" cannot be parsed or is not supported.";
-                output += number[j];
-                if (j == int(number.size()) - 2)
-                  output += " and ";
-                else if (j != int(number.size()) - 1)
-                  output += ", ";
-              }
-            output += termination;
-          }
-        else if (expression[0] == '=')
+        const vector<string>& number = number_str_[i];
+        switch (kind_[i])
           {
-            str = trim(expression.substr(1));
-            vector<string> number = split(str);
-            output += " - Value equal to ";
+          case unsupported:
+            throw "Error in show_constraint: the constraint \""
+              + expression_[i] + "\" cannot be parsed.";
+          case invalid:
+            ThrowInvalid(i, "show_constraint");
+            break;
+          case less_equal:
+            output += " - Value less than " + number[0] + termination;
+            break;
+          case less:
+            output += " - Value strictly less than " + number[0]
+              + termination;
+            break;
+          case greater_equal:
+            output += " - Value greater than " + number[0] + termination;
+            break;
+          case greater:
+            output += " - Value strictly greater than " + number[0]
+              + termination;
+            break;
+          case different:
+          case equal:
+            if (invalid_[i] != -1)
+              ThrowInvalid(i, "show_constraint");
+            if (kind_[i] == different)
+              output += " - Value different from ";
+            else
+              output += " - Value equal to ";
             for (int j = 0; j < int(number.size()); j++)
               {
-                if (!is_num(number[j]))
-                  throw "Error in show_constraint: the constraint \""
-                    + expression + "\" cannot be parsed or is not supported.";
                 output += number[j];
                 if (j == int(number.size()) - 2)
-                  output += " or ";
+                  output += kind_[i] == different ? " and " : " or ";
                 else if (j != int(number.size()) - 1)
                   output += ", ";
               }
             output += termination;
+            break;
+          case positive:
+            output += " - Positive value" + termination;
+            break;
+          case strictly_positive:
+            output += " - Strictly positive value" + termination;
+            break;
+          case negative:
+            output += " - Negative value" + termination;
+            break;
+          case strictly_negative:
+            output += " - Strictly negative value" + termination;
+            break;
+          case non_zero:
+            output += " - Non-zero value" + termination;
+            break;
+          case integer:
+            output += " - Integral value" + termination;
+            break;
           }
-        else if (expression == "positive")
-          output += " - Positive value" + termination;
-        else if (expression == "strictly positive")
-          output += " - Strictly positive value" + termination;
-        else if (expression == "negative")
-          output += " - Negative value" + termination;
-        else if (expression == "strictly negative")
-          output += " - Strictly negative value" + termination;
-        else if (expression == "non zero")
-          output += " - Non-zero value" + termination;
-        else if (expression == "integer")
-          output += " - Integral value" + termination;
-        else
-          throw "Error in show_constraint: the constraint \""
-            + expression + "\" cannot be parsed or is not supported.";
       }
 
     return output;
   }
 
+  //! Throws an exception for a constraint that cannot be parsed.
+  /*!
+    \param i the index of the constraint.
+    \param function the name of the function for the error message.
+  */
+  template <class T>
+  void ConstraintSet<T>::ThrowInvalid(int i, string function) const
+  {
+    throw "Error in " + function + ": the constraint \"" + expression_[i]
+      + "\" cannot be parsed or is not supported.";
+  }
+
+
+  //! Checks whether a numerical value satisfies a list of constraints.
+  /*!
+    The list is parsed once (see 'ConstraintSet').
+    \param value the numerical value.
+    \param constraint the list of constraints. The constraints are delimited
+    by |. The supported constraints are: positive, strictly positive,
+    negative, strictly negative, non zero, integer, > x, >= x, < x, <= x, != x
+    y z, = x y z.
+    \return true if the constraints are satisfied, false otherwise.
+  */
+  template <class T>
+  bool satisfies_constraint(T value, string constraint)
+  {
+    const ConstraintSet<T>* constraint_set = ConstraintSet<T>::Get(constraint);
+    if (constraint_set != NULL)
+      return constraint_set->Satisfies(value);
+    return ConstraintSet<T>(constraint).Satisfies(value);
+  }
+
+  //! Formats a list of constraints in a string readable for human beings.
+  /*!
+    The list is parsed once (see 'ConstraintSet').
+    \param constraint the list of constraints. The constraints are delimited
+    by |. The supported constraints are: positive, strictly positive,
+    negative, strictly negative, non zero, integer, > x, >= x, < x, <= x, != x
+    y z, = x y z.
+    \return The constraints in a readable string.
+  */
+  string show_constraint(string constraint)
+  {
+    const ConstraintSet<double>* constraint_set
+      = ConstraintSet<double>::Get(constraint);
+    if (constraint_set != NULL)
+      return constraint_set->Show();
+    return ConstraintSet<double>(constraint).Show();
+  }
+
 
   /////////////////
   // SEARCHSCOPE //
@@ -409,6 +515,34 @@ namespace Talos
       searching_ = "";
     }
 
+#ifdef TALOS_DEBUG
+    //! Registers a field searched for in a file.
+    /*!
+      \param file_name the file where the search takes place.
+      \param delimiters the delimiters with which the file is read.
+      \param searching the term being searched for.
+    */
+    static void AddToRegister(const string& file_name,
+                              const string& delimiters,
+                              const string& searching)
+    {
+      // The register may be filled from several threads, through
+      // 'ConfigCursor'.
+      static std::mutex register_mutex;
+      std::lock_guard<std::mutex> lock(register_mutex);
+      reg.file[file_name].insert(searching);
+      string& delimiter = reg.delimiter[file_name];
+      if (delimiter.empty())
+        delimiter = delimiters;
+      else if (delimiter != delimiters)
+        {
+          throw "\"" + file_name + "\" has been opened with different "
+            "delimiters: once with \"" + delimiter + "\", "
+            "another with \"" + delimiters + "\"";
+        }
+    }
+#endif
+
   private:
     SearchScope(const SearchScope&);
     string& searching_;
@@ -416,16 +550,7 @@ namespace Talos
 #ifdef TALOS_DEBUG
     void AddToRegister(ExtStream& stream)
     {
-      reg.file[stream.file_name_].insert(searching_);
-      string& delimiter = reg.delimiter[stream.file_name_];
-      if (delimiter.empty())
-        delimiter = stream.delimiters_;
-      else if (delimiter != stream.delimiters_)
-        {
-          throw "\"" + stream.file_name_ + "\" has been opened with different "
-            "delimiters: once with \"" + delimiter + "\", "
-            "another with \"" + stream.delimiters_ + "\"";
-        }
+      AddToRegister(stream.file_name_, stream.delimiters_, searching_);
     }
 
     //! Fields that has been searched for through the configuration files.
@@ -522,123 +647,336 @@ namespace Talos
   SearchScope::Register SearchScope::reg = SearchScope::Register();
 #endif
 
-  ///////////////
-  // EXTSTREAM //
-  ///////////////
+  //////////////////
+  // MAPPEDBUFFER //
+  //////////////////
 
   //! Default constructor.
-  /*! Nothing is performed.
+  /*! Nothing is mapped.
    */
-  ExtStream::ExtStream():
-    comments_("#%"), delimiters_(" \t:=|\n,;\r\x0D\x0A"), searching_("")
-  {
-  }
-
-  //! Main constructor.
-  /*! Opens a file.
-    \param file_name file to be opened.
-  */
-  ExtStream::ExtStream(string file_name,
-                       string comments,
-                       string delimiters):
-    ifstream(file_name.c_str(), ifstream::binary), file_name_(file_name),
-    comments_(comments), delimiters_(delimiters), searching_("")
+  MappedBuffer::MappedBuffer():
+    data_(NULL), size_(0), mapped_(false), descriptor_(-1)
   {
-    if (!this->is_open())
-      throw string("Unable to open file \"") + file_name + "\".";
   }
 
   //! Destructor.
-  /*! Closes the stream.
+  /*! Unmaps the file, if any.
    */
-  ExtStream::~ExtStream()
+  MappedBuffer::~MappedBuffer()
   {
-    this->close();
+    Unmap();
   }
 
-  //! Checks whether a line should be discarded.
+  //! Maps a file in memory.
   /*!
-    \param line line to be checked.
-    \return true if the line should be discarded, false otherwise.
+    \param file_name the file to be mapped.
+    \return true if the file could be mapped, false otherwise (e.g., if the
+    file is not a regular file, or if memory mapping is not supported).
+    \note If a file was previously mapped, it is unmapped.
   */
-  bool ExtStream::Discard(string line) const
+  bool MappedBuffer::Map(string file_name)
   {
-    size_t first = line.find_first_not_of(delimiters_);
-    return ((first == string::npos)
-            || (comments_.find_first_of(line[first]) != string::npos));
+    Unmap();
+
+#if defined(TALOS_MMAP)
+    int descriptor = ::open(file_name.c_str(), O_RDONLY);
+    if (descriptor == -1)
+      return false;
+
+    struct stat status;
+    if (::fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode))
+      {
+        ::close(descriptor);
+        return false;
+      }
+
+    size_ = size_t(status.st_size);
+    if (size_ != 0)
+      {
+        void* data = ::mmap(NULL, size_, PROT_READ, MAP_PRIVATE,
+                            descriptor, 0);
+        if (data == MAP_FAILED)
+          {
+            ::close(descriptor);
+            size_ = 0;
+            return false;
+          }
+        data_ = static_cast<char*>(data);
+        ::madvise(data, size_, MADV_SEQUENTIAL);
+      }
+    descriptor_ = descriptor;
+
+    this->setg(data_, data_, data_ + size_);
+    mapped_ = true;
+#else
+    (void) file_name;
+#endif
+
+    return mapped_;
   }
 
-  //! Skips discarded lines.
-  /*!
-    Extracts discarded lines.
-    \return A reference to the current stream.
-  */
-  ExtStream& ExtStream::SkipDiscarded()
+  //! Unmaps the file.
+  void MappedBuffer::Unmap()
   {
-    std::streampos position;
-    while ((!is_empty(*this)) && (Discard(PeekFullLine(position))))
-      this->seekg(position);
-    return *this;
+#if defined(TALOS_MMAP)
+    if (data_ != NULL)
+      ::munmap(data_, size_);
+    if (descriptor_ != -1)
+      ::close(descriptor_);
+#endif
+    data_ = NULL;
+    size_ = 0;
+    mapped_ = false;
+    descriptor_ = -1;
+    this->setg(NULL, NULL, NULL);
   }
 
-  //! Sets the characters considered as delimiters.
+  //! Is a file mapped?
   /*!
-    \param delimiters delimiters.
+    \return true if a file is mapped, false otherwise.
   */
-  void ExtStream::SetDelimiters(string delimiters)
+  bool MappedBuffer::IsMapped() const
   {
-    delimiters_ = delimiters;
+    return mapped_;
   }
 
-  //! Sets the characters that denote a comment line.
+  //! Checks whether the size of the mapped file has changed.
   /*!
-    \param comments the characters that denote a comment line.
+    \return true if the size of the mapped file is not the size of the
+    mapped region anymore (e.g., if another process truncated the file),
+    false otherwise or if no file is mapped.
   */
-  void ExtStream::SetComments(string comments)
+  bool MappedBuffer::HasChanged() const
   {
-    comments_ = comments;
+#if defined(TALOS_MMAP)
+    struct stat status;
+    if (descriptor_ != -1)
+      return ::fstat(descriptor_, &status) != 0
+        || size_t(status.st_size) != size_;
+#endif
+    return false;
   }
 
-  //! Returns the characters considered as delimiters..
+  //! Returns the beginning of the mapped region.
   /*!
-    \return Delimiters.
+    \return A pointer to the first character of the file.
   */
-  string ExtStream::GetDelimiters() const
+  const char* MappedBuffer::Begin() const
   {
-    return delimiters_;
+    return this->eback();
   }
 
-  //! Returns the characters that denote a comment line.
+  //! Returns the current position in the mapped region.
   /*!
-    \return The characters that denote a comment line.
+    \return A pointer to the next character to be read.
   */
-  string ExtStream::GetComments() const
+  const char* MappedBuffer::Current() const
   {
-    return comments_;
+    return this->gptr();
   }
 
-  //! Returns the name of the file that was opened.
+  //! Returns the end of the mapped region.
   /*!
-    \return The name of the file that was opened.
+    \return A pointer past the last character of the file.
   */
-  string ExtStream::GetFileName() const
+  const char* MappedBuffer::End() const
   {
-    return file_name_;
+    return this->egptr();
   }
 
-  //! Skips delimiters.
+  //! Sets the current position in the mapped region.
   /*!
-    Extracts following delimiters from the string, until another character
-    is found.
-    \return A reference to the current stream.
+    \param position pointer to the next character to be read. It should be
+    in the mapped region.
   */
-  ExtStream& ExtStream::SkipDelimiters()
+  void MappedBuffer::SetCurrent(const char* position)
   {
-    while (this->good()
-           && (delimiters_.find_first_of(char(this->peek()))
-               != string::npos))
-      this->get();
-    return *this;
+    this->setg(this->eback(), this->eback() + (position - this->eback()),
+               this->egptr());
+  }
+
+  //! Sets the position relatively to a given location.
+  /*!
+    \param offset offset from \a way.
+    \param way location from which the offset is counted.
+    \param which the get area is the only area.
+    \return The new position, or -1 if the position is invalid.
+  */
+  MappedBuffer::pos_type
+  MappedBuffer::seekoff(off_type offset, std::ios_base::seekdir way,
+                        std::ios_base::openmode which)
+  {
+    if (!mapped_ || !(which & std::ios_base::in))
+      return pos_type(off_type(-1));
+
+    off_type position;
+    if (way == std::ios_base::beg)
+      position = offset;
+    else if (way == std::ios_base::cur)
+      position = off_type(this->gptr() - this->eback()) + offset;
+    else
+      position = off_type(size_) + offset;
+
+    if (position < 0 || position > off_type(size_))
+      return pos_type(off_type(-1));
+
+    this->setg(this->eback(), this->eback() + position, this->egptr());
+    return pos_type(position);
+  }
+
+  //! Sets the position.
+  /*!
+    \param position the new position.
+    \param which the get area is the only area.
+    \return The new position, or -1 if the position is invalid.
+  */
+  MappedBuffer::pos_type
+  MappedBuffer::seekpos(pos_type position, std::ios_base::openmode which)
+  {
+    return seekoff(off_type(position), std::ios_base::beg, which);
+  }
+
+  //! Returns the number of characters left.
+  /*!
+    \return The number of characters left, or -1 at the end of the file.
+  */
+  std::streamsize MappedBuffer::showmanyc()
+  {
+    return this->gptr() < this->egptr() ? this->egptr() - this->gptr() : -1;
+  }
+
+
+  ///////////////
+  // EXTSTREAM //
+  ///////////////
+
+  //! Default constructor.
+  /*! Nothing is performed.
+   */
+  ExtStream::ExtStream():
+    comments_("#%"), delimiters_(" \t:=|\n,;\r\x0D\x0A"), searching_("")
+  {
+    UpdateCharacterTables();
+  }
+
+  //! Main constructor.
+  /*! Opens a file.
+    \param file_name file to be opened.
+  */
+  ExtStream::ExtStream(string file_name,
+                       string comments,
+                       string delimiters):
+    ifstream(file_name.c_str(), ifstream::binary), file_name_(file_name),
+    comments_(comments), delimiters_(delimiters), searching_("")
+  {
+    if (!this->is_open())
+      throw string("Unable to open file \"") + file_name + "\".";
+
+    UpdateCharacterTables();
+    Map();
+  }
+
+  //! Destructor.
+  /*! Closes the stream.
+   */
+  ExtStream::~ExtStream()
+  {
+    Unmap();
+    this->close();
+  }
+
+  //! Checks whether a line should be discarded.
+  /*!
+    \param line line to be checked.
+    \return true if the line should be discarded, false otherwise.
+  */
+  bool ExtStream::Discard(string line) const
+  {
+    size_t first = line.find_first_not_of(delimiters_);
+    return ((first == string::npos)
+            || (comments_.find_first_of(line[first]) != string::npos));
+  }
+
+  //! Skips discarded lines.
+  /*!
+    Extracts discarded lines.
+    \return A reference to the current stream.
+  */
+  ExtStream& ExtStream::SkipDiscarded()
+  {
+    if (mapped_buffer_.IsMapped() && this->good())
+      {
+        SkipMappedDiscarded();
+        return *this;
+      }
+
+    std::streampos position;
+    while ((!is_empty(*this)) && (Discard(PeekFullLine(position))))
+      this->seekg(position);
+    return *this;
+  }
+
+  //! Sets the characters considered as delimiters.
+  /*!
+    \param delimiters delimiters.
+  */
+  void ExtStream::SetDelimiters(string delimiters)
+  {
+    delimiters_ = delimiters;
+    UpdateCharacterTables();
+    ClearCache();
+  }
+
+  //! Sets the characters that denote a comment line.
+  /*!
+    \param comments the characters that denote a comment line.
+  */
+  void ExtStream::SetComments(string comments)
+  {
+    comments_ = comments;
+    UpdateCharacterTables();
+    ClearCache();
+  }
+
+  //! Returns the characters considered as delimiters..
+  /*!
+    \return Delimiters.
+  */
+  string ExtStream::GetDelimiters() const
+  {
+    return delimiters_;
+  }
+
+  //! Returns the characters that denote a comment line.
+  /*!
+    \return The characters that denote a comment line.
+  */
+  string ExtStream::GetComments() const
+  {
+    return comments_;
+  }
+
+  //! Returns the name of the file that was opened.
+  /*!
+    \return The name of the file that was opened.
+  */
+  string ExtStream::GetFileName() const
+  {
+    return file_name_;
+  }
+
+  //! Skips delimiters.
+  /*!
+    Extracts following delimiters from the string, until another character
+    is found.
+    \return A reference to the current stream.
+  */
+  ExtStream& ExtStream::SkipDelimiters()
+  {
+    while (this->good()
+           && is_delimiter_[(unsigned char)(this->peek())])
+      this->get();
+    return *this;
   }
 
   //! Removes delimiters at both ends of a string.
@@ -677,6 +1015,8 @@ namespace Talos
   */
   void ExtStream::Open(string file_name, openmode mode)
   {
+    Unmap();
+    ClearCache();
     this->close();
     this->clear();
     this->open(file_name.c_str(), mode);
@@ -685,6 +1025,9 @@ namespace Talos
 
     if (!this->is_open())
       throw string("Unable to open file \"") + file_name + "\".";
+
+    if (!(mode & out))
+      Map();
   }
 
   //! Closes the current file.
@@ -693,12 +1036,24 @@ namespace Talos
   */
   void ExtStream::Close()
   {
+    Unmap();
+    ClearCache();
     this->close();
     this->clear();
 
     file_name_ = "";
   }
 
+  //! Checks whether the file is memory-mapped.
+  /*!
+    \return true if the stream reads from a memory-mapped file, false if it
+    reads through the file buffer.
+  */
+  bool ExtStream::IsMapped() const
+  {
+    return mapped_buffer_.IsMapped();
+  }
+
   //! Checks whether the stream is empty.
   /*!
     Checks whether the stream has still valid elements to be read.
@@ -713,10 +1068,16 @@ namespace Talos
   //! Rewinds the stream.
   /*!
     Goes back to the beginning of the stream and clears the control state.
+    If the size of the mapped file has changed, the stream reads through the
+    file buffer from now on.
     \return A reference to the current stream.
   */
   ExtStream& ExtStream::Rewind()
   {
+    // The mapped region of a truncated file cannot be read anymore.
+    if (mapped_buffer_.HasChanged())
+      Unmap();
+
     this->clear();
     this->seekg(0, ifstream::beg);
 
@@ -751,6 +1112,15 @@ namespace Talos
   */
   string ExtStream::PeekFullLine()
   {
+    if (mapped_buffer_.IsMapped() && this->good())
+      {
+        const char* current = mapped_buffer_.Current();
+        const char* end = mapped_buffer_.End();
+        const char* line_end = static_cast<const char*>
+          (memchr(current, '\n', end - current));
+        return string(current, line_end == NULL ? end : line_end);
+      }
+
     std::streampos position = this->tellg();
     iostate state = this->rdstate();
 
@@ -770,6 +1140,20 @@ namespace Talos
   */
   string ExtStream::PeekFullLine(std::streampos& position)
   {
+    if (mapped_buffer_.IsMapped() && this->good())
+      {
+        const char* current = mapped_buffer_.Current();
+        const char* end = mapped_buffer_.End();
+        const char* line_end = static_cast<const char*>
+          (memchr(current, '\n', end - current));
+        // As with 'tellg' after a line that reaches the end of the file.
+        if (line_end == NULL)
+          position = std::streampos(std::streamoff(-1));
+        else
+          position = std::streampos(line_end + 1 - mapped_buffer_.Begin());
+        return string(current, line_end == NULL ? end : line_end);
+      }
+
     std::streampos position_back = this->tellg();
     iostate state = this->rdstate();
 
@@ -963,17 +1347,13 @@ namespace Talos
   {
     SearchScope s(*this, element);
 
-    string elt;
-    while (GetElement(elt) && elt != element);
-
-    if (elt == "")
+    if (!SkipToElement(element))
       throw string("Error in ExtStream::Find: \"")
         + element + string("\" not found in \"") + file_name_ + "\".";
 
     searching_ = "";
 
-
-    return elt == element;
+    return true;
   }
 
   //! Sets the position of the get pointer after a given element.
@@ -996,32 +1376,76 @@ namespace Talos
   */
   string ExtStream::GetElement()
   {
-    std::streampos position;
-    string element;
-    string::size_type index, length;
-
-    while ((!is_empty(*this)) && (Discard(PeekFullLine(position))))
-      this->seekg(position);
-    element = PeekFullLine();
+    return GetElementView().str();
+  }
 
-    index = element.find_first_not_of(delimiters_);
-    if (index != string::npos)
+  //! Returns a view on the next valid element.
+  /*!
+    Returns the next valid element, i.e. the next element that is not in a
+    line to be discarded. The element is not copied: the view refers to the
+    mapped file or to an internal line buffer, and it should not be used
+    after the next operation on the stream.
+    \return A view on the next valid element, empty if there is no element
+    left.
+  */
+  StringView ExtStream::GetElementView()
+  {
+    if (!this->good())
       {
-        length = element.find_first_of(delimiters_, index);
-        length = length == string::npos ? element.size() - index
-          : length - index;
-        element = element.substr(index, length);
+        this->setstate(failbit);
+        return StringView();
       }
-    else
+
+    if (mapped_buffer_.IsMapped())
       {
-        index = element.size();
-        length = 0;
-        element = "";
+        if (!SkipMappedDiscarded())
+          return StringView();
+        const char* current = mapped_buffer_.Current();
+        const char* end = mapped_buffer_.End();
+        while (current != end && *current != '\n'
+               && is_delimiter_[(unsigned char)(*current)])
+          ++current;
+        const char* element_end = current;
+        while (element_end != end && *element_end != '\n'
+               && !is_delimiter_[(unsigned char)(*element_end)])
+          ++element_end;
+        mapped_buffer_.SetCurrent(element_end);
+        return StringView(current, element_end - current);
       }
 
-    this->seekg(index + length, ifstream::cur);
+    // Discarded lines are read only once, and the stream is positioned
+    // back only in the line that contains the element.
+    std::streampos position = this->tellg();
+    iostate state = this->rdstate();
+    while (std::getline(*this, line_buffer_))
+      {
+        const char* line = line_buffer_.data();
+        size_t length = line_buffer_.size();
+        size_t index = 0;
+        while (index != length && is_delimiter_[(unsigned char)(line[index])])
+          index++;
+        if (index != length && !is_comment_[(unsigned char)(line[index])])
+          {
+            size_t index_end = index;
+            while (index_end != length
+                   && !is_delimiter_[(unsigned char)(line[index_end])])
+              index_end++;
+            this->clear(state);
+            this->seekg(position + std::streamoff(index_end));
+            return StringView(line + index, index_end - index);
+          }
+        // The last line, without newline, is discarded.
+        if (this->eof())
+          {
+            this->clear(failbit);
+            return StringView();
+          }
+        position += std::streamoff(length + 1);
+      }
 
-    return element;
+    this->clear(state);
+    this->seekg(position);
+    return StringView();
   }
 
   //! Gets the next valid element.
@@ -1062,6 +1486,15 @@ namespace Talos
   */
   string ExtStream::PeekElement()
   {
+    if (mapped_buffer_.IsMapped() && this->good())
+      {
+        const char* initial_position = mapped_buffer_.Current();
+        string element = GetElement();
+        this->clear();
+        mapped_buffer_.SetCurrent(initial_position);
+        return element;
+      }
+
     std::streampos initial_position;
     string element;
 
@@ -1118,9 +1551,10 @@ namespace Talos
   double ExtStream::GetNumber()
   {
     string element;
-    while (GetElement(element) && !is_num(element));
+    double number = 0.;
+    while (GetElement(element) && !is_num(element, number));
 
-    return is_num(element) ? to_num<double>(element) : 0.;
+    return number;
   }
 
   //! Gets the next valid number.
@@ -1134,9 +1568,10 @@ namespace Talos
   {
     string element;
     bool success;
-    while ((success = GetElement(element)) && !is_num(element));
+    while ((success = GetElement(element)) && !is_num(element, number));
 
-    number = is_num(element) ? to_num<T>(element) : T(0);
+    if (!success)
+      number = T(0);
 
     return success;
   }
@@ -1153,12 +1588,13 @@ namespace Talos
     iostate state = this->rdstate();
 
     string element;
-    while (GetElement(element) && !is_num(element));
+    double number = 0.;
+    while (GetElement(element) && !is_num(element, number));
 
     this->clear(state);
     this->seekg(initial_position);
 
-    return is_num(element) ? to_num<double>(element) : 0.;
+    return number;
   }
 
   //! Gets the next valid number without extracting it from the stream.
@@ -1175,9 +1611,10 @@ namespace Talos
 
     string element;
     bool success;
-    while ((success = GetElement(element)) && !is_num(element));
+    while ((success = GetElement(element)) && !is_num(element, number));
 
-    number = is_num(element) ? to_num<T>(element) : T(0);
+    if (!success)
+      number = T(0);
 
     this->clear(state);
     this->seekg(initial_position);
@@ -1195,6 +1632,52 @@ namespace Talos
       this->GetNumber();
   }
 
+  //! Gets a sequence of numbers.
+  /*!
+    Gets the next 'N' valid elements, which must all be numbers. This is
+    much faster than successive calls to 'GetNumber' since the numbers are
+    parsed in place, without intermediate strings. Elements are read as with
+    'GetRawElement': no markup is substituted.
+    \param numbers (output) the numbers. It must point to at least 'N'
+    elements.
+    \param N number of numbers to be read.
+    \warning Unlike 'GetNumber', invalid elements are not skipped: an
+    exception is thrown at the first element that is not a number.
+  */
+  template <class T>
+  void ExtStream::GetNumbers(T* numbers, size_t N)
+  {
+    for (size_t i = 0; i < N; i++)
+      {
+        StringView element = GetElementView();
+        if (element.empty())
+          throw string("Error in ExtStream::GetNumbers: only ") + to_str(i)
+            + " number(s) out of " + to_str(N) + " could be read in \""
+            + file_name_ + "\".";
+        if (parse_num(element.begin(), element.end(), numbers[i])
+            != element.end())
+          throw string("Error in ExtStream::GetNumbers: element #")
+            + to_str(i) + " (\"" + element.str() + "\") in \"" + file_name_
+            + "\" is not a number.";
+      }
+  }
+
+  //! Gets a sequence of numbers.
+  /*!
+    Gets as many valid elements as there are entries in 'numbers'. The
+    elements must all be numbers.
+    \param numbers (input/output) the numbers. Its size is the number of
+    numbers to be read.
+    \warning Unlike 'GetNumber', invalid elements are not skipped: an
+    exception is thrown at the first element that is not a number.
+  */
+  template <class T>
+  void ExtStream::GetNumbers(vector<T>& numbers)
+  {
+    if (!numbers.empty())
+      GetNumbers(&numbers[0], numbers.size());
+  }
+
   //! Gets the value of a given variable.
   /*!
     Gets the value of a given variable, i.e. the next valid
@@ -1206,10 +1689,7 @@ namespace Talos
   {
     SearchScope s(*this, name);
 
-    string element;
-    while (GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ExtStream::GetValue: \"")
         + name + string("\" not found in \"") + file_name_ + "\".";
 
@@ -1252,20 +1732,16 @@ namespace Talos
     SearchScope s(*this, name);
 
     string element;
-    while (GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ExtStream::GetValue: \"")
         + name + string("\" not found in \"") + file_name_ + "\".";
     if (!this->GetElement(element))
       throw string("Error in ExtStream::GetValue: unable to read value of \"")
         + name + string("\" in \"") + file_name_ + "\".";
-    if (!is_num(element))
+    if (!is_num(element, value))
       throw string("Error in ExtStream::GetValue: the value of \"") + name
         + string("\" in \"") + file_name_ + string("\" is \"") + element
         + "\", but it should be a number.";
-
-    value = to_num<T>(element);
   }
 
   //! Gets the value of a given variable.
@@ -1280,9 +1756,7 @@ namespace Talos
     SearchScope s(*this, name);
 
     string element;
-    while (GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ExtStream::GetValue: \"")
         + name + string("\" not found in \"") + file_name_ + "\".";
     if (!this->GetElement(element))
@@ -1380,7 +1854,7 @@ namespace Talos
       throw string("Error in ExtStream::GetValue: the value of \"")
         + name + string("\" in \"") + file_name_ + "\" is "
         + to_str(value) + " but it should satisfy the following "
-        + "constraint(s):\n" + show_constraint(constraint);
+        + "constraint(s):\n" + ConstraintSet<T>(constraint).Show();
   }
 
   /*! \brief Gets the value of a given variable without extracting them from
@@ -1420,10 +1894,7 @@ namespace Talos
   {
     SearchScope s(*this, name);
 
-    string element;
-    while (GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ExtStream::GetValue: \"")
         + name + string("\" not found in \"") + file_name_ + "\".";
 
@@ -1451,17 +1922,16 @@ namespace Talos
     std::streampos initial_position = this->tellg();
     iostate state = this->rdstate();
 
-    string element;
-    while (GetElement(element) && element != name);
+    bool found = SkipToElement(name);
 
-    // if (element != name)
+    // if (!found)
     //   cout << string("Warning in ExtStream::CheckValue: \"")
     //     + name + string("\" not found in \"") + file_name_ + "\"." << endl;
 
     this->clear(state);
     this->seekg(initial_position);
 
-    return (element == name);
+    return found;
   }
 
 
@@ -1542,10 +2012,7 @@ namespace Talos
   {
     SearchScope s(*this, name);
 
-    string element;
-    while (GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ExtStream::GetValue: \"")
         + name + string("\" not found in \"") + file_name_ + "\".";
 
@@ -1605,6 +2072,98 @@ namespace Talos
       }
   }
 
+  //! Maps the file in memory, if possible.
+  /*!
+    On success, the stream reads from the mapped file instead of the file
+    buffer.
+  */
+  void ExtStream::Map()
+  {
+    if (mapped_buffer_.Map(file_name_))
+      this->std::ios::rdbuf(&mapped_buffer_);
+  }
+
+  //! Unmaps the file and goes back to the file buffer.
+  void ExtStream::Unmap()
+  {
+    if (mapped_buffer_.IsMapped())
+      {
+        this->std::ios::rdbuf(ifstream::rdbuf());
+        mapped_buffer_.Unmap();
+      }
+  }
+
+  //! Extracts elements up to a given element.
+  /*!
+    \param element the element to be found.
+    \return true if the element was found, in which case the get pointer is
+    exactly after it, false if the end of the stream was reached.
+  */
+  bool ExtStream::SkipToElement(const string& element)
+  {
+    StringView elt;
+    while (!(elt = GetElementView()).empty())
+      if (elt == element)
+        return true;
+    return false;
+  }
+
+  //! Discards the data derived from the file or from its tokenization.
+  /*!
+    Called whenever the file, the delimiters or the comment characters
+    change. Nothing is cached at this level.
+  */
+  void ExtStream::ClearCache()
+  {
+  }
+
+  //! Updates the tables of delimiters and comment characters.
+  void ExtStream::UpdateCharacterTables()
+  {
+    for (int i = 0; i < 256; i++)
+      {
+        is_delimiter_[i] = false;
+        is_comment_[i] = false;
+      }
+    for (size_t i = 0; i < delimiters_.size(); i++)
+      is_delimiter_[(unsigned char)(delimiters_[i])] = true;
+    for (size_t i = 0; i < comments_.size(); i++)
+      is_comment_[(unsigned char)(comments_[i])] = true;
+  }
+
+  //! Skips discarded lines in the mapped file.
+  /*!
+    \return false if the last line of the file is discarded and is not
+    terminated by a newline, true otherwise. In the first case, the stream
+    is set in a failed state, as when reading through the file buffer.
+  */
+  bool ExtStream::SkipMappedDiscarded()
+  {
+    const char* current = mapped_buffer_.Current();
+    const char* end = mapped_buffer_.End();
+    while (current != end)
+      {
+        const char* line_end = static_cast<const char*>
+          (memchr(current, '\n', end - current));
+        const char* first = current;
+        while (first != (line_end == NULL ? end : line_end)
+               && is_delimiter_[(unsigned char)(*first)])
+          ++first;
+        if (first != (line_end == NULL ? end : line_end)
+            && !is_comment_[(unsigned char)(*first)])
+          break;
+        if (line_end == NULL)
+          {
+            mapped_buffer_.SetCurrent(current);
+            this->setstate(failbit);
+            return false;
+          }
+        current = line_end + 1;
+      }
+    mapped_buffer_.SetCurrent(current);
+    return true;
+  }
+
 
   //////////////////
   // CONFIGSTREAM //
@@ -1613,7 +2172,9 @@ namespace Talos
   //! Default constructor.
   /*! Nothing is performed.
    */
-  ConfigStream::ConfigStream(): ExtStream()
+  ConfigStream::ConfigStream():
+    ExtStream(), markup_definition_built_(false),
+    section_position_built_(false)
   {
     markup_tags_ = "<>$";
     section_ = "";
@@ -1628,7 +2189,8 @@ namespace Talos
                              string delimiters,
                              string markup_tags):
     ExtStream(file_name, comments, delimiters),
-    markup_tags_(markup_tags)
+    markup_tags_(markup_tags), markup_definition_built_(false),
+    section_position_built_(false)
   {
     section_ = "";
   }
@@ -1649,6 +2211,24 @@ namespace Talos
   void ConfigStream::SetSection(string section)
   {
     section_ = "";
+    if (section != "" && IsSection(section))
+      {
+        // Section flags are located once and for all.
+        if (!section_position_built_)
+          BuildSectionPositions();
+        unordered_map<string, std::streamoff>::const_iterator position
+          = section_position_.find(section);
+        if (position != section_position_.end())
+          {
+#ifdef TALOS_DEBUG
+            SearchScope::AddToRegister(file_name_, delimiters_, section);
+#endif
+            this->clear();
+            this->seekg(position->second);
+            section_ = section;
+            return;
+          }
+      }
     if (section != "")
       {
         this->FindFromBeginning(section);
@@ -1672,6 +2252,8 @@ namespace Talos
   void ConfigStream::SetMarkupTags(string markup_tags)
   {
     markup_tags_ = markup_tags;
+    markup_value_.clear();
+    markup_section_end_.clear();
   }
 
   //! Returns the markup tags.
@@ -1720,12 +2302,13 @@ namespace Talos
 
     std::streampos initial_position = this->tellg();
 
-    string elt;
-    while (ExtStream::GetRawElement(elt) && elt != element
+    StringView elt;
+    while (!(elt = GetElementView()).empty() && elt != element
            && (section_ == "" || !IsSection(elt)));
+    bool found = elt == element;
 
     this->seekg(initial_position);
-    return elt == element;
+    return found;
   }
 
 
@@ -1740,22 +2323,23 @@ namespace Talos
   {
     SearchScope s(*this, element);
 
-    string elt;
-    while (ExtStream::GetRawElement(elt) && elt != element
-           && (section_ == "" || !IsSection(elt)));
+    StringView elt;
+    if (!SkipSection(element))
+      while (!(elt = GetElementView()).empty() && elt != element
+             && (section_ == "" || !IsSection(elt)));
 
-    if (section_ != "" && (elt == "" || IsSection(elt)))
+    if (section_ != "" && (elt.empty() || IsSection(elt)))
       throw string("Error in ConfigStream::Find: end of section \"")
         + section_ + string("\" has been reached in file \"")
         + this->file_name_ + string("\".\nUnable to find \"")
         + element + "\".";
-    if (elt == "")
+    if (elt.empty())
       throw string("Error in ConfigStream::Find: \"")
         + element + string("\" not found in \"") + this->file_name_ + "\".";
 
     this->searching_ = "";
 
-    return elt == element;
+    return true;
   }
 
   //! Sets the position of the get pointer after a given element.
@@ -1781,12 +2365,30 @@ namespace Talos
   */
   string ConfigStream::GetElement()
   {
-    string tmp;
+    string element = SubstituteMarkups(ExtStream::GetElement());
 
-    string element = ExtStream::GetElement();
+    if (!section_.empty() && (element == "" || IsSection(element)))
+      ThrowEndOfSection();
 
-    std::streampos initial_position = this->tellg();
-    iostate state = this->rdstate();
+    return element;
+  }
+
+  //! Replaces the markups of an element with their values.
+  /*!
+    If a section is selected, the end of the section is reached when a
+    markup value is empty or is a section flag, or is obtained through such
+    a value.
+    \param element the element.
+    \param function name of the calling method, for error messages.
+    \param section_end (output) if not NULL, set to true if the end of a
+    section would be reached, instead of checking the end of the section.
+    \return The element with its markups replaced with their values.
+  */
+  string ConfigStream::SubstituteMarkups(string element, string function,
+                                         bool* section_end)
+  {
+    if (element.find_first_of(markup_tags_) == string::npos)
+      return element;
 
     vector<string> elements;
     vector<bool> is_markup;
@@ -1800,78 +2402,204 @@ namespace Talos
         element += elements[i];
       else
         {
-          this->Rewind();
-          tmp = ExtStream::GetElement();
-          while (tmp != elements[i] && tmp != "")
-            tmp = ExtStream::GetElement();
-          if (tmp == "")
-            throw string("Error in ConfigStream::GetElement:")
-              + string(" the value of the markup \"")
-              + elements[i] + string("\" was not found in \"")
-              + file_name_ + "\".";
-          element += this->GetElement();
+          const string& value = GetMarkupValue(elements[i], function);
+          bool end = value == "" || IsSection(value)
+            || markup_section_end_.count(elements[i]) != 0;
+          if (section_end != NULL)
+            *section_end = *section_end || end;
+          else if (!section_.empty() && end)
+            ThrowEndOfSection();
+          element += value;
         }
 
-    this->clear(state);
-    this->seekg(initial_position);
+    return element;
+  }
 
-    if (!section_.empty() && (element == "" || IsSection(element)))
+  //! Returns the value of a markup.
+  /*!
+    The value of a markup is the element following the first occurrence of
+    the markup name in the file, with its own markups replaced. Each markup
+    is resolved once: its value is then kept until the file, the delimiters,
+    the comment characters or the markup tags change.
+    \param markup the markup name.
+    \param function name of the calling method, for error messages.
+    \return The value of the markup.
+  */
+  string ConfigStream::GetMarkupValue(const string& markup,
+                                      const string& function)
+  {
+    unordered_map<string, string>::const_iterator value
+      = markup_value_.find(markup);
+    if (value != markup_value_.end())
+      return value->second;
+
+    if (!markup_definition_built_)
+      BuildMarkupDefinitions();
+
+    unordered_map<string, string>::const_iterator definition
+      = markup_definition_.find(markup);
+    if (definition == markup_definition_.end())
+      throw string("Error in ConfigStream::") + function + ":"
+        + string(" the value of the markup \"")
+        + markup + string("\" was not found in \"")
+        + file_name_ + "\".";
+
+    if (find(markup_resolving_.begin(), markup_resolving_.end(), markup)
+        != markup_resolving_.end())
       {
-        string message = string("End of section \"") + section_
-          + string("\" has been reached in file \"") + this->file_name_
-          + "\".";
-        if (this->searching_ != "")
-          message += string("\nUnable to find \"")
-            + this->searching_ + string("\".");
-        throw message;
+        string cycle;
+        for (int i = 0; i < int(markup_resolving_.size()); i++)
+          cycle += markup_resolving_[i] + " -> ";
+        markup_resolving_.clear();
+        throw string("Error in ConfigStream::") + function + ":"
+          + string(" the markup \"") + markup
+          + string("\" is defined in terms of itself (") + cycle + markup
+          + string(") in \"") + file_name_ + "\".";
       }
 
-    return element;
+    markup_resolving_.push_back(markup);
+    string result;
+    bool section_end = false;
+    try
+      {
+        result = SubstituteMarkups(definition->second, function,
+                                   &section_end);
+      }
+    catch (...)
+      {
+        markup_resolving_.clear();
+        throw;
+      }
+    markup_resolving_.pop_back();
+
+    if (section_end)
+      markup_section_end_.insert(markup);
+    return markup_value_[markup] = result;
   }
 
-  //! Returns the next valid line.
+  //! Builds the table of markup definitions.
   /*!
-    Returns the next valid line, i.e. the next line that is
-    not a line to be discarded and from which comments have been extracted.
-    \return The next valid line.
+    The stream is read once, and the element following the first occurrence
+    of every element is stored. The position of the stream is left
+    unchanged.
   */
-  string ConfigStream::GetLine()
+  void ConfigStream::BuildMarkupDefinitions()
   {
-    string tmp;
-
-    string element = ExtStream::GetLine();
-
     std::streampos initial_position = this->tellg();
     iostate state = this->rdstate();
+    this->Rewind();
 
-    vector<string> elements;
-    vector<bool> is_markup;
+    string previous, current;
+    bool first = true;
+    StringView element;
+    while (!(element = GetElementView()).empty())
+      {
+        current = element.str();
+        if (!first)
+          markup_definition_.insert(make_pair(previous, current));
+        previous.swap(current);
+        first = false;
+      }
+    // The value of the last element is empty.
+    if (!first)
+      markup_definition_.insert(make_pair(previous, string("")));
 
-    split_markup(element, elements, is_markup, markup_tags_);
+    this->clear(state);
+    this->seekg(initial_position);
 
-    element = "";
+    markup_definition_built_ = true;
+  }
 
-    for (int i = 0; i < int(elements.size()); i++)
-      if (!is_markup[i])
-        element += elements[i];
-      else
+  //! Discards the markup definitions and values, and the section positions.
+  void ConfigStream::ClearCache()
+  {
+    markup_definition_.clear();
+    markup_definition_built_ = false;
+    markup_value_.clear();
+    markup_section_end_.clear();
+
+    section_position_built_ = false;
+    section_begin_.clear();
+    section_end_.clear();
+    section_position_.clear();
+  }
+
+  //! Computes the positions of the section flags.
+  /*!
+    The stream is read once. The position of the stream is left unchanged.
+  */
+  void ConfigStream::BuildSectionPositions()
+  {
+    std::streampos initial_position = this->tellg();
+    iostate state = this->rdstate();
+    this->Rewind();
+
+    StringView element;
+    while (!(element = GetElementView()).empty())
+      if (IsSection(element))
         {
-          this->Rewind();
-          tmp = ExtStream::GetElement();
-          while (tmp != elements[i] && tmp != "")
-            tmp = ExtStream::GetElement();
-          if (tmp == "")
-            throw string("Error in ConfigStream::GetLine:")
-              + string(" the value of the markup \"")
-              + elements[i] + string("\" was not found in \"")
-              + file_name_ + "\".";
-          element += this->GetElement();
+          std::streamoff end = this->tellg();
+          section_begin_.push_back(end - std::streamoff(element.size()));
+          section_end_.push_back(end);
+          section_position_.insert(make_pair(element.str(), end));
         }
 
     this->clear(state);
     this->seekg(initial_position);
 
-    return element;
+    section_position_built_ = true;
+  }
+
+  //! Skips the rest of the current section if it cannot contain an element.
+  /*!
+    If a section is selected and the mapped file has no occurrence of \a
+    element before the next section flag, the stream is positioned right
+    after this flag (or at the end of the stream, in a failed state), as if
+    the section had been read.
+    \param element the element to be found.
+    \return true if the rest of the section was skipped, false otherwise.
+  */
+  bool ConfigStream::SkipSection(const string& element)
+  {
+    if (section_ == "" || !section_position_built_ || !IsMapped()
+        || !this->good())
+      return false;
+
+    std::streamoff position
+      = mapped_buffer_.Current() - mapped_buffer_.Begin();
+    vector<std::streamoff>::const_iterator next
+      = lower_bound(section_begin_.begin(), section_begin_.end(), position);
+    const char* end = next == section_begin_.end() ? mapped_buffer_.End()
+      : mapped_buffer_.Begin() + *next;
+
+    if (std::search(mapped_buffer_.Current(), end, element.begin(),
+                    element.end()) != end)
+      return false;
+
+    if (next == section_begin_.end())
+      {
+        mapped_buffer_.SetCurrent(end);
+        GetElementView();
+      }
+    else
+      this->seekg(section_end_[next - section_begin_.begin()]);
+    return true;
+  }
+
+  //! Returns the next valid line.
+  /*!
+    Returns the next valid line, i.e. the next line that is
+    not a line to be discarded and from which comments have been extracted.
+    \return The next valid line.
+  */
+  string ConfigStream::GetLine()
+  {
+    string line = ExtStream::GetLine();
+    // A line that ends the file leaves the stream in a failed state, without
+    // the end-of-file flag, as in previous versions.
+    if (this->eof())
+      this->clear((this->rdstate() & ~eofbit) | failbit);
+    return SubstituteMarkups(line, "GetLine");
   }
 
   //! Returns the next valid line.
@@ -1882,51 +2610,267 @@ namespace Talos
   */
   bool ConfigStream::GetLine(string& line)
   {
-    string tmp;
-
     bool success = ExtStream::GetLine(line);
+    if (this->eof())
+      this->clear((this->rdstate() & ~eofbit) | failbit);
+    line = SubstituteMarkups(line, "GetLine");
+    return success;
+  }
 
-    std::streampos initial_position = this->tellg();
-    iostate state = this->rdstate();
+  //! Checks whether a string is a section flag.
+  /*!
+    \param str string to be tested.
+    \return True if 'str' is a section flag, false otherwise.
+  */
+  bool ConfigStream::IsSection(string str) const
+  {
+    return str[0] == '[' && str[str.size() - 1] == ']';
+  }
 
-    vector<string> elements;
-    vector<bool> is_markup;
+  //! Checks whether an element is a section flag.
+  /*!
+    \param str element to be tested.
+    \return True if 'str' is a section flag, false otherwise.
+  */
+  bool ConfigStream::IsSection(const StringView& str) const
+  {
+    return !str.empty() && str[0] == '[' && str[str.size() - 1] == ']';
+  }
 
-    split_markup(line, elements, is_markup, markup_tags_);
+  //! Checks whether a section flag is in the file.
+  /*!
+    \param section the section flag.
+    \return false if \a section is a section flag that is not in the file,
+    true otherwise.
+  */
+  bool ConfigStream::CheckSection(const string& section)
+  {
+    if (section == "" || !IsSection(section))
+      return true;
+    if (!section_position_built_)
+      BuildSectionPositions();
+    return section_position_.find(section) != section_position_.end();
+  }
 
-    line = "";
+  //! Extracts elements up to a given element.
+  /*!
+    Elements are compared to \a element after markup substitution.
+    \param element the element to be found.
+    \return true if the element was found, in which case the get pointer is
+    exactly after it, false if the end of the stream was reached.
+    \note An exception is thrown if the end of the current section (if any)
+    is reached.
+  */
+  bool ConfigStream::SkipToElement(const string& element)
+  {
+    StringView elt;
+    while (!(elt = GetElementView()).empty())
+      {
+        bool has_markup = false;
+        for (size_t i = 0; i < elt.size() && !has_markup; i++)
+          has_markup = markup_tags_.find(elt[i]) != string::npos;
 
-    for (int i = 0; i < int(elements.size()); i++)
-      if (!is_markup[i])
-        line += elements[i];
-      else
-        {
-          this->Rewind();
-          tmp = ExtStream::GetElement();
-          while (tmp != elements[i] && tmp != "")
-            tmp = ExtStream::GetElement();
-          if (tmp == "")
-            throw string("Error in ConfigStream::GetLine:")
-              + string(" the value of the markup \"")
-              + elements[i] + string("\" was not found in \"")
-              + file_name_ + "\".";
-          line += this->GetElement();
-        }
+        if (has_markup)
+          {
+            string substituted = SubstituteMarkups(elt.str());
+            if (substituted == "")
+              break;
+            if (!section_.empty() && IsSection(substituted))
+              ThrowEndOfSection();
+            if (substituted == element)
+              return true;
+          }
+        else
+          {
+            if (!section_.empty() && IsSection(elt))
+              ThrowEndOfSection();
+            if (elt == element)
+              return true;
+          }
+      }
 
-    this->clear(state);
-    this->seekg(initial_position);
+    if (!section_.empty())
+      ThrowEndOfSection();
 
-    return success;
+    return false;
   }
 
-  //! Checks whether a string is a section flag.
+  //! Throws an exception stating that the end of the section was reached.
+  void ConfigStream::ThrowEndOfSection() const
+  {
+    string message = string("End of section \"") + section_
+      + string("\" has been reached in file \"") + this->file_name_
+      + "\".";
+    if (this->searching_ != "")
+      message += string("\nUnable to find \"")
+        + this->searching_ + string("\".");
+    throw message;
+  }
+
+
+  /////////////////////////
+  // CONFIGURATION CACHE //
+  /////////////////////////
+
+  //! Identifies the binary cache files of 'ConfigStreams'.
+  static const char config_cache_magic_[] = "TALOSCFG";
+  //! Version of the format of the binary cache files.
+  static const unsigned long long config_cache_version_ = 1;
+  //! Written in the cache files to detect a change of byte order.
+  static const unsigned long long config_cache_endianness_
+  = 0x0102030405060708ULL;
+
+  //! Appends an integer to a cache buffer.
   /*!
-    \param str string to be tested.
-    \return True if 'str' is a section flag, false otherwise.
+    \param buffer the cache buffer.
+    \param value the integer, stored on 64 bits.
   */
-  bool ConfigStream::IsSection(string str) const
+  template <class T>
+  void cache_write(string& buffer, const T& value)
   {
-    return str[0] == '[' && str[str.size() - 1] == ']';
+    unsigned long long stored = static_cast<unsigned long long>(value);
+    buffer.append(reinterpret_cast<const char*>(&stored), sizeof(stored));
+  }
+
+  //! Appends a string to a cache buffer.
+  /*!
+    \param buffer the cache buffer.
+    \param value the string, stored with its length.
+  */
+  void cache_write(string& buffer, const string& value)
+  {
+    cache_write(buffer, value.size());
+    buffer.append(value);
+  }
+
+  //! Appends a vector to a cache buffer.
+  /*!
+    \param buffer the cache buffer.
+    \param value the vector, stored with its length.
+  */
+  template <class T>
+  void cache_write(string& buffer, const vector<T>& value)
+  {
+    cache_write(buffer, value.size());
+    for (int i = 0; i < int(value.size()); i++)
+      cache_write(buffer, value[i]);
+  }
+
+  //! Reads an integer from a cache buffer.
+  /*!
+    \param position (input/output) the current position in the buffer.
+    \param end the end of the buffer.
+    \param value (output) the integer.
+    \return True if the integer could be read, false if the buffer is too
+    short.
+  */
+  template <class T>
+  bool cache_read(const char*& position, const char* end, T& value)
+  {
+    unsigned long long stored;
+    if (end - position < std::ptrdiff_t(sizeof(stored)))
+      return false;
+    memcpy(&stored, position, sizeof(stored));
+    position += sizeof(stored);
+    value = static_cast<T>(stored);
+    return true;
+  }
+
+  //! Reads a string from a cache buffer.
+  /*!
+    \param position (input/output) the current position in the buffer.
+    \param end the end of the buffer.
+    \param value (output) the string.
+    \return True if the string could be read, false if the buffer is too
+    short.
+  */
+  bool cache_read(const char*& position, const char* end, string& value)
+  {
+    unsigned long long size;
+    if (!cache_read(position, end, size)
+        || size > static_cast<unsigned long long>(end - position))
+      return false;
+    value.assign(position, size);
+    position += size;
+    return true;
+  }
+
+  //! Reads a vector from a cache buffer.
+  /*!
+    \param position (input/output) the current position in the buffer.
+    \param end the end of the buffer.
+    \param value (output) the vector.
+    \return True if the vector could be read, false if the buffer is too
+    short.
+  */
+  template <class T>
+  bool cache_read(const char*& position, const char* end, vector<T>& value)
+  {
+    unsigned long long size;
+    // Every item takes at least 8 bytes.
+    if (!cache_read(position, end, size)
+        || size > static_cast<unsigned long long>(end - position) / 8)
+      return false;
+    value.resize(size);
+    for (int i = 0; i < int(size); i++)
+      if (!cache_read(position, end, value[i]))
+        return false;
+    return true;
+  }
+
+  //! Computes the FNV-1a hash of a sequence of bytes.
+  /*!
+    \param data the bytes.
+    \param size the number of bytes.
+    \param hash the hash of the bytes preceding 'data', if any.
+    \return The hash of the bytes.
+  */
+  unsigned long long cache_hash(const char* data, size_t size,
+                                unsigned long long hash
+                                = 0xcbf29ce484222325ULL)
+  {
+    for (size_t i = 0; i < size; i++)
+      {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001b3ULL;
+      }
+    return hash;
+  }
+
+  //! Computes the signature of a file.
+  /*!
+    The signature is made of the size of the file, its modification time
+    (when available) and a hash (FNV-1a) of its contents.
+    \param file_name the file name.
+    \param signature (output) the signature, appended to a cache buffer.
+    \return True if the file could be read, false otherwise.
+  */
+  bool cache_file_signature(string file_name, string& signature)
+  {
+    ifstream file(file_name.c_str(), ifstream::binary);
+    if (!file.is_open())
+      return false;
+
+    unsigned long long size = 0;
+    unsigned long long hash = cache_hash(NULL, 0);
+    char buffer[65536];
+    while (file.read(buffer, sizeof(buffer)) || file.gcount() > 0)
+      {
+        hash = cache_hash(buffer, size_t(file.gcount()), hash);
+        size += file.gcount();
+      }
+
+    long long modification = 0;
+#if defined(__unix__) || defined(__APPLE__)
+    struct stat status;
+    if (stat(file_name.c_str(), &status) == 0)
+      modification = static_cast<long long>(status.st_mtime);
+#endif
+
+    cache_write(signature, size);
+    cache_write(signature, modification);
+    cache_write(signature, hash);
+    return true;
   }
 
 
@@ -1938,7 +2882,8 @@ namespace Talos
   /*! Nothing is performed.
    */
   ConfigStreams::ConfigStreams():
-    streams_(0), current_(streams_.begin()), section_(""), searching_("")
+    streams_(0), current_(streams_.begin()), section_(""), searching_(""),
+    index_built_(false)
   {
   }
 
@@ -1948,7 +2893,7 @@ namespace Talos
   */
   ConfigStreams::ConfigStreams(const vector<string>& files):
     streams_(files.size()), current_(streams_.begin()), section_(""),
-    searching_("")
+    searching_(""), index_built_(false)
   {
     for (int i = 0; i < int(files.size()); i++)
       streams_[i] = new ConfigStream(files[i]);
@@ -1959,7 +2904,8 @@ namespace Talos
     \param file file to be opened.
   */
   ConfigStreams::ConfigStreams(string file):
-    streams_(1), current_(streams_.begin()), section_(""), searching_("")
+    streams_(1), current_(streams_.begin()), section_(""), searching_(""),
+    index_built_(false)
   {
     streams_[0] = new ConfigStream(file);
   }
@@ -1970,7 +2916,8 @@ namespace Talos
     \param file1 second file to be opened.
   */
   ConfigStreams::ConfigStreams(string file0, string file1):
-    streams_(2), current_(streams_.begin()), section_(""), searching_("")
+    streams_(2), current_(streams_.begin()), section_(""), searching_(""),
+    index_built_(false)
   {
     streams_[0] = new ConfigStream(file0);
     streams_[1] = new ConfigStream(file1);
@@ -1983,7 +2930,8 @@ namespace Talos
     \param file2 third file to be opened.
   */
   ConfigStreams::ConfigStreams(string file0, string file1, string file2):
-    streams_(3), current_(streams_.begin()), section_(""), searching_("")
+    streams_(3), current_(streams_.begin()), section_(""), searching_(""),
+    index_built_(false)
   {
     streams_[0] = new ConfigStream(file0);
     streams_[1] = new ConfigStream(file1);
@@ -2025,6 +2973,8 @@ namespace Talos
     unsigned int l = current_ - streams_.begin();
     streams_.push_back(new ConfigStream(file));
     current_ = streams_.begin() + l;
+
+    ClearIndex();
   }
 
   //! Deselects the section.
@@ -2050,30 +3000,11 @@ namespace Talos
       (*current_)->SetSection("");
 
     current_ = streams_.begin();
-    bool found = false;
-    try
-      {
-        (*current_)->SetSection(section);
-        found = true;
-      }
-    catch (...)
-      {
-        (*current_)->Rewind();
-        (*current_)->section_ = section_;
-      }
+    bool found = SelectSection(**current_);
     while (!found && current_ != streams_.end() - 1)
       {
         ++current_;
-        try
-          {
-            (*current_)->SetSection(section_);
-            found = true;
-          }
-        catch (...)
-          {
-            (*current_)->Rewind();
-            (*current_)->section_ = section_;
-          }
+        found = SelectSection(**current_);
       }
 
     if (!found)
@@ -2313,43 +3244,12 @@ namespace Talos
   */
   bool ConfigStreams::GetLine(string& line)
   {
-    string tmp;
-
     line = this->GetRawLine();
     bool success = (line != "");
+    (*current_)->clear((*current_)->rdstate() & ~ifstream::eofbit);
+    RewindOthers();
 
-    vector<ConfigStream*>::iterator iter = current_;
-    std::streampos initial_position = (*current_)->tellg();
-    ifstream::iostate state = (*current_)->rdstate();
-
-    vector<string> elements;
-    vector<bool> is_markup;
-
-    split_markup(line, elements, is_markup, (*current_)->GetMarkupTags());
-
-    line = "";
-
-    for (int i = 0; i < int(elements.size()); i++)
-      if (!is_markup[i])
-        line += elements[i];
-      else
-        {
-          this->Rewind();
-          tmp = this->GetRawElement();
-          while (tmp != elements[i] && tmp != "")
-            tmp = this->GetRawElement();
-          if (tmp == "")
-            throw string("Error in ConfigStreams::GetLine:")
-              + string(" the value of the markup \"")
-              + elements[i] + string("\" was not found in ")
-              + FileNames() + ".";
-          line += this->GetElement();
-        }
-
-    this->Rewind();
-    current_ = iter;
-    (*current_)->clear(state);
-    (*current_)->seekg(initial_position);
+    line = SubstituteMarkups(line, (*current_)->GetMarkupTags(), "GetLine");
 
     return success;
   }
@@ -2446,6 +3346,50 @@ namespace Talos
   {
     SearchScope s(*this, element);
 
+    // With the index, the element is located before any stream is read.
+    int first = GetElementIndex();
+    if (first != -1)
+      {
+        int current = int(current_ - streams_.begin());
+        int Nstream = int(streams_.size());
+        unordered_map<string, vector<int> >::const_iterator occurrence
+          = occurrence_.find(element);
+        int stream = current, index = -1;
+        for (; stream < Nstream && index == -1; stream++)
+          {
+            int begin = stream == current ? first : stream_element_[stream];
+            int end = stream_element_[stream + 1];
+            int limit = SectionLimit(stream, begin);
+            if (occurrence != occurrence_.end())
+              {
+                vector<int>::const_iterator it
+                  = lower_bound(occurrence->second.begin(),
+                                occurrence->second.end(), begin);
+                if (it != occurrence->second.end() && *it < min(end, limit))
+                  index = *it;
+              }
+          }
+
+        if (index != -1)
+          {
+            // Each stream is left as after an unsuccessful search.
+            for (; current_ != streams_.begin() + element_stream_[index];
+                 ++current_)
+              {
+                int i = int(current_ - streams_.begin());
+                int limit = SectionLimit(i, i == current ? first
+                                         : stream_element_[i]);
+                if (limit < stream_element_[i + 1])
+                  (*current_)->seekg(element_end_[limit]);
+                else
+                  SkipToEnd(i);
+              }
+            (*current_)->seekg(element_end_[index]);
+            searching_ = "";
+            return true;
+          }
+      }
+
     bool found;
     try
       {
@@ -2517,55 +3461,18 @@ namespace Talos
   */
   string ConfigStreams::GetElement()
   {
-    string tmp;
-
     string element = GetRawElement();
+    (*current_)->clear((*current_)->rdstate() & ~ifstream::eofbit);
+    RewindOthers();
 
-    vector<ConfigStream*>::iterator iter = current_;
-    std::streampos initial_position = (*current_)->tellg();
-    ifstream::iostate state = (*current_)->rdstate();
-
-    vector<string> elements;
-    vector<bool> is_markup;
-
-    split_markup(element, elements, is_markup, (*current_)->GetMarkupTags());
+    element = SubstituteMarkups(element, (*current_)->GetMarkupTags(),
+                                "GetElement");
 
-    element = "";
+    if (!section_.empty() && (element == "" || IsSection(element)))
+      ThrowEndOfSection();
 
-    for (int i = 0; i < int(elements.size()); i++)
-      if (!is_markup[i])
-        element += elements[i];
-      else
-        {
-          this->Rewind();
-          tmp = GetRawElement();
-          while (tmp != elements[i] && tmp != "")
-            tmp = GetRawElement();
-          if (tmp == "")
-            throw string("Error in ConfigStreams::GetElement: ")
-              + string("the value of the markup \"")
-              + elements[i] + string("\" was not found in ")
-              + FileNames() + ".";
-          element += this->GetElement();
-        }
-
-    this->Rewind();
-    current_ = iter;
-    (*current_)->clear(state);
-    (*current_)->seekg(initial_position);
-
-    if (!section_.empty() && (element == "" || IsSection(element)))
-      {
-        string message = string("End of section \"") + section_
-          + string("\" has been reached in ") + FileNames() + ".";
-        if (searching_ != "")
-          message += string("\nUnable to find \"")
-            + this->searching_ + string("\".");
-        throw message;
-      }
-
-    return element;
-  }
+    return element;
+  }
 
   //! Gets the next valid element.
   /*!
@@ -2646,9 +3553,10 @@ namespace Talos
   double ConfigStreams::GetNumber()
   {
     string element;
-    while (this->GetElement(element) && !is_num(element));
+    double number = 0.;
+    while (this->GetElement(element) && !is_num(element, number));
 
-    return is_num(element) ? to_num<double>(element) : 0.;
+    return number;
   }
 
   //! Gets the next valid number.
@@ -2662,9 +3570,11 @@ namespace Talos
   {
     string element;
     bool success;
-    while ((success = this->GetElement(element)) && !is_num(element));
+    while ((success = this->GetElement(element))
+           && !is_num(element, number));
 
-    number = is_num(element) ? to_num<T>(element) : T(0);
+    if (!success)
+      number = T(0);
 
     return success;
   }
@@ -2735,10 +3645,7 @@ namespace Talos
   {
     SearchScope s(*this, name);
 
-    string element;
-    while (this->GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ConfigStreams::GetValue: \"")
         + name + string("\" not found in ") + FileNames() + ".";
 
@@ -2784,20 +3691,16 @@ namespace Talos
     SearchScope s(*this, name);
 
     string element;
-    while (this->GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ConfigStreams::GetValue: \"")
         + name + string("\" not found in ") + FileNames() + ".";
     if (!this->GetElement(element))
       throw string("Error in ConfigStreams::GetValue: unable to read value")
         + string(" of \"") + name + string("\" in ") + FileNames() + ".";
-    if (!is_num(element))
+    if (!is_num(element, value))
       throw string("Error in ConfigStreams::GetValue: the value of \"") + name
         + string("\" in ") + FileNames() + string(" is \"") + element
         + "\", but it should be a number.";
-
-    value = to_num<T>(element);
   }
 
   //! Gets the value of a given variable.
@@ -2812,9 +3715,7 @@ namespace Talos
     SearchScope s(*this, name);
 
     string element;
-    while (this->GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ConfigStreams::GetValue: \"")
         + name + string("\" not found in ") + FileNames() + ".";
     if (!this->GetElement(element))
@@ -2918,7 +3819,7 @@ namespace Talos
       throw string("Error in ConfigStreams::GetValue: the value of \"")
         + name + string("\" in ") + FileNames() + " is "
         + to_str(value) + " but it should satisfy the following "
-        + "constraint(s):\n" + show_constraint(constraint);
+        + "constraint(s):\n" + ConstraintSet<T>(constraint).Show();
   }
 
   /*! \brief Gets the value of a given variable without extracting them from
@@ -2961,10 +3862,7 @@ namespace Talos
   {
     SearchScope s(*this, name);
 
-    string element;
-    while (this->GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ConfigStreams::GetValue: \"")
         + name + string("\" not found in ") + FileNames() + ".";
 
@@ -3055,10 +3953,7 @@ namespace Talos
   {
     SearchScope s(*this, name);
 
-    string element;
-    while (this->GetElement(element) && element != name);
-
-    if (element != name)
+    if (!SkipToElement(name))
       throw string("Error in ConfigStreams::GetValue: \"")
         + name + string("\" not found in ") + FileNames() + ".";
 
@@ -3092,6 +3987,228 @@ namespace Talos
     (*current_)->seekg(initial_position);
   }
 
+  //! Saves the index of the elements to a binary cache file.
+  /*!
+    The index of the elements of all streams, the markup definitions and the
+    values of the markups found in the streams are written to \a file_name,
+    together with the names, the sizes, the modification times and a hash of
+    the contents of the configuration files. 'LoadCache' then restores them
+    without tokenizing the files. The cache file is written under a
+    temporary name and then renamed, so that it is never read half-written.
+    \param file_name the cache file name.
+  */
+  void ConfigStreams::SaveCache(string file_name)
+  {
+    string buffer;
+    if (!GetCacheKey(buffer))
+      throw string("Error in ConfigStreams::SaveCache: unable to read ")
+        + FileNames() + ".";
+
+    if (!index_built_)
+      BuildIndex();
+
+    // Resolves the markups of the streams, so that their values are saved.
+    bool section_end = false;
+    for (int i = 0; i < int(markup_element_.size()); i++)
+      try
+        {
+          int stream = element_stream_[markup_element_[i]];
+          SubstituteMarkups(markup_raw_element_[i],
+                            streams_[stream]->GetMarkupTags(), "SaveCache",
+                            &section_end);
+        }
+      catch (string&)
+        {
+        }
+
+    size_t key_size = buffer.size();
+    cache_write(buffer, element_stream_);
+    cache_write(buffer, element_end_);
+    cache_write(buffer, stream_element_);
+    cache_write(buffer, occurrence_.size());
+    for (unordered_map<string, vector<int> >::const_iterator it
+           = occurrence_.begin(); it != occurrence_.end(); ++it)
+      {
+        cache_write(buffer, it->first);
+        cache_write(buffer, it->second);
+      }
+    cache_write(buffer, section_element_);
+    cache_write(buffer, markup_element_);
+    cache_write(buffer, markup_raw_element_);
+    cache_write(buffer, markup_definition_.size());
+    for (unordered_map<string, pair<string, int> >::const_iterator it
+           = markup_definition_.begin(); it != markup_definition_.end(); ++it)
+      {
+        cache_write(buffer, it->first);
+        cache_write(buffer, it->second.first);
+        cache_write(buffer, it->second.second);
+      }
+    cache_write(buffer, markup_value_.size());
+    for (unordered_map<string, string>::const_iterator it
+           = markup_value_.begin(); it != markup_value_.end(); ++it)
+      {
+        cache_write(buffer, it->first);
+        cache_write(buffer, it->second);
+      }
+    cache_write(buffer, markup_section_end_.size());
+    for (unordered_set<string>::const_iterator it
+           = markup_section_end_.begin(); it != markup_section_end_.end();
+         ++it)
+      cache_write(buffer, *it);
+    cache_write(buffer, cache_hash(buffer.data() + key_size,
+                                   buffer.size() - key_size));
+
+    string temporary = file_name + ".tmp";
+#if defined(__unix__) || defined(__APPLE__)
+    temporary += to_str(getpid());
+#endif
+    ofstream file(temporary.c_str(), ofstream::binary);
+    file.write(buffer.data(), std::streamsize(buffer.size()));
+    file.close();
+    if (file.fail() || std::rename(temporary.c_str(), file_name.c_str()) != 0)
+      {
+        std::remove(temporary.c_str());
+        throw string("Error in ConfigStreams::SaveCache: unable to write \"")
+          + file_name + "\".";
+      }
+  }
+
+  //! Loads the index of the elements from a binary cache file.
+  /*!
+    The cache file is read at once. It is only used if it was saved (with
+    'SaveCache') for the same files, with the same comments, delimiters and
+    markup tags, and if the files have not changed since then.
+    \param file_name the cache file name.
+    \return True if the index was loaded, false if the cache file is
+    missing, invalid or out of date, in which case nothing is changed.
+  */
+  bool ConfigStreams::LoadCache(string file_name)
+  {
+    ifstream file(file_name.c_str(), ifstream::binary);
+    if (!file.is_open())
+      return false;
+    file.seekg(0, ios::end);
+    std::streamoff length = file.tellg();
+    if (length <= 0)
+      return false;
+    string buffer(size_t(length), '\0');
+    file.seekg(0, ios::beg);
+    if (!file.read(&buffer[0], std::streamsize(length)))
+      return false;
+
+    string key;
+    if (!GetCacheKey(key) || buffer.compare(0, key.size(), key) != 0)
+      return false;
+
+    // The contents are followed by their hash.
+    const char* position = buffer.data() + key.size();
+    const char* end = buffer.data() + buffer.size();
+    unsigned long long hash;
+    if (end - position < std::ptrdiff_t(sizeof(hash)))
+      return false;
+    end -= sizeof(hash);
+    memcpy(&hash, end, sizeof(hash));
+    if (hash != cache_hash(position, size_t(end - position)))
+      return false;
+
+    vector<int> element_stream, stream_element, section_element,
+      markup_element;
+    vector<std::streamoff> element_end;
+    unordered_map<string, vector<int> > occurrence;
+    vector<string> markup_raw_element;
+    unordered_map<string, pair<string, int> > markup_definition;
+    unordered_map<string, string> markup_value;
+    unordered_set<string> markup_section_end;
+
+    string name, value;
+    vector<int> index;
+    int stream;
+    size_t size;
+    if (!cache_read(position, end, element_stream)
+        || !cache_read(position, end, element_end)
+        || !cache_read(position, end, stream_element)
+        || !cache_read(position, end, size))
+      return false;
+    for (size_t i = 0; i < size; i++)
+      if (!cache_read(position, end, name)
+          || !cache_read(position, end, index))
+        return false;
+      else
+        occurrence[name].swap(index);
+    if (!cache_read(position, end, section_element)
+        || !cache_read(position, end, markup_element)
+        || !cache_read(position, end, markup_raw_element)
+        || !cache_read(position, end, size))
+      return false;
+    for (size_t i = 0; i < size; i++)
+      if (!cache_read(position, end, name)
+          || !cache_read(position, end, value)
+          || !cache_read(position, end, stream))
+        return false;
+      else
+        markup_definition[name] = make_pair(value, stream);
+    if (!cache_read(position, end, size))
+      return false;
+    for (size_t i = 0; i < size; i++)
+      if (!cache_read(position, end, name)
+          || !cache_read(position, end, value))
+        return false;
+      else
+        markup_value[name] = value;
+    if (!cache_read(position, end, size))
+      return false;
+    for (size_t i = 0; i < size; i++)
+      if (!cache_read(position, end, name))
+        return false;
+      else
+        markup_section_end.insert(name);
+    if (position != end || element_end.size() != element_stream.size()
+        || stream_element.size() != streams_.size() + 1)
+      return false;
+
+    ClearIndex();
+    element_stream_.swap(element_stream);
+    element_end_.swap(element_end);
+    stream_element_.swap(stream_element);
+    occurrence_.swap(occurrence);
+    section_element_.swap(section_element);
+    markup_element_.swap(markup_element);
+    markup_raw_element_.swap(markup_raw_element);
+    markup_definition_.swap(markup_definition);
+    markup_value_.swap(markup_value);
+    markup_section_end_.swap(markup_section_end);
+    index_built_ = true;
+
+    SetSectionPositions();
+
+    return true;
+  }
+
+  //! Loads the index from a cache file, or builds it and saves the cache.
+  /*!
+    If the cache file cannot be used, the files are read and the cache file
+    is (re)written. A failure to write the cache file is ignored.
+    \param file_name the cache file name.
+    \return True if the index was loaded from the cache file, false if it was
+    built from the files.
+  */
+  bool ConfigStreams::UseCache(string file_name)
+  {
+    if (LoadCache(file_name))
+      return true;
+
+    try
+      {
+        SaveCache(file_name);
+      }
+    catch (string&)
+      {
+        if (!index_built_)
+          BuildIndex();
+      }
+    return false;
+  }
+
   //! Checks whether a string is a section flag.
   /*!
     \param str string to be tested.
@@ -3147,6 +4264,1919 @@ namespace Talos
       }
   }
 
+  //! Builds the key that identifies the files in a cache file.
+  /*!
+    \param key (output) the key: the format of the cache file, then the name,
+    the comments, the delimiters, the markup tags and the signature of every
+    file.
+    \return True if all files could be read, false otherwise.
+  */
+  bool ConfigStreams::GetCacheKey(string& key) const
+  {
+    key.assign(config_cache_magic_, 8);
+    cache_write(key, config_cache_version_);
+    cache_write(key, config_cache_endianness_);
+    cache_write(key, streams_.size());
+    for (int i = 0; i < int(streams_.size()); i++)
+      {
+        cache_write(key, streams_[i]->GetFileName());
+        cache_write(key, streams_[i]->GetComments());
+        cache_write(key, streams_[i]->GetDelimiters());
+        cache_write(key, streams_[i]->GetMarkupTags());
+        if (!cache_file_signature(streams_[i]->GetFileName(), key))
+          return false;
+      }
+    return true;
+  }
+
+  //! Sets the positions of the section flags of the streams from the index.
+  /*!
+    This spares the streams a reading of their files in 'SetSection'.
+  */
+  void ConfigStreams::SetSectionPositions()
+  {
+    vector<pair<int, const string*> > section;
+    for (unordered_map<string, vector<int> >::const_iterator it
+           = occurrence_.begin(); it != occurrence_.end(); ++it)
+      if (IsSection(it->first))
+        for (int i = 0; i < int(it->second.size()); i++)
+          section.push_back(make_pair(it->second[i], &it->first));
+    sort(section.begin(), section.end());
+
+    for (int i = 0; i < int(streams_.size()); i++)
+      {
+        streams_[i]->section_begin_.clear();
+        streams_[i]->section_end_.clear();
+        streams_[i]->section_position_.clear();
+        streams_[i]->section_position_built_ = true;
+      }
+
+    for (int i = 0; i < int(section.size()); i++)
+      {
+        ConfigStream& stream = *streams_[element_stream_[section[i].first]];
+        std::streamoff end = element_end_[section[i].first];
+        const string& element = *section[i].second;
+        stream.section_begin_.push_back(end
+                                        - std::streamoff(element.size()));
+        stream.section_end_.push_back(end);
+        stream.section_position_.insert(make_pair(element, end));
+      }
+  }
+
+  //! Replaces the markups of an element with their values.
+  /*!
+    If a section is selected, the end of the section is reached when a
+    markup value is empty or is a section flag, or is obtained through such
+    a value.
+    \param element the element.
+    \param markup_tags the markup tags of the stream the element belongs to.
+    \param function name of the calling method, for error messages.
+    \param section_end (output) if not NULL, set to true if the end of a
+    section would be reached, instead of checking the end of the section.
+    \return The element with its markups replaced with their values.
+  */
+  string ConfigStreams::SubstituteMarkups(string element,
+                                          const string& markup_tags,
+                                          const string& function,
+                                          bool* section_end)
+  {
+    if (element.find_first_of(markup_tags) == string::npos)
+      return element;
+
+    vector<string> elements;
+    vector<bool> is_markup;
+
+    split_markup(element, elements, is_markup, markup_tags);
+
+    element = "";
+
+    for (int i = 0; i < int(elements.size()); i++)
+      if (!is_markup[i])
+        element += elements[i];
+      else
+        {
+          const string& value = GetMarkupValue(elements[i], function);
+          bool end = value == "" || IsSection(value)
+            || markup_section_end_.count(elements[i]) != 0;
+          if (section_end != NULL)
+            *section_end = *section_end || end;
+          else if (!section_.empty() && end)
+            ThrowEndOfSection();
+          element += value;
+        }
+
+    return element;
+  }
+
+  //! Returns the value of a markup.
+  /*!
+    The value of a markup is the element following the first occurrence of
+    the markup name in the streams, with its own markups replaced. Each
+    markup is resolved once: its value is then kept until a file is added.
+    \param markup the markup name.
+    \param function name of the calling method, for error messages.
+    \return The value of the markup.
+  */
+  string ConfigStreams::GetMarkupValue(const string& markup,
+                                       const string& function)
+  {
+    unordered_map<string, string>::const_iterator value
+      = markup_value_.find(markup);
+    if (value != markup_value_.end())
+      return value->second;
+
+    if (!index_built_)
+      BuildIndex();
+
+    unordered_map<string, pair<string, int> >::const_iterator definition
+      = markup_definition_.find(markup);
+    if (definition == markup_definition_.end())
+      throw string("Error in ConfigStreams::") + function + ": "
+        + string("the value of the markup \"")
+        + markup + string("\" was not found in ")
+        + FileNames() + ".";
+
+    if (find(markup_resolving_.begin(), markup_resolving_.end(), markup)
+        != markup_resolving_.end())
+      {
+        string cycle;
+        for (int i = 0; i < int(markup_resolving_.size()); i++)
+          cycle += markup_resolving_[i] + " -> ";
+        markup_resolving_.clear();
+        throw string("Error in ConfigStreams::") + function + ": "
+          + string("the markup \"") + markup
+          + string("\" is defined in terms of itself (") + cycle + markup
+          + string(") in ") + FileNames() + ".";
+      }
+
+    markup_resolving_.push_back(markup);
+    string result;
+    bool section_end = false;
+    try
+      {
+        result = SubstituteMarkups(definition->second.first,
+                                   streams_[definition->second.second]
+                                   ->GetMarkupTags(), function,
+                                   &section_end);
+      }
+    catch (...)
+      {
+        markup_resolving_.clear();
+        throw;
+      }
+    markup_resolving_.pop_back();
+
+    if (section_end)
+      markup_section_end_.insert(markup);
+    return markup_value_[markup] = result;
+  }
+
+  //! Builds the index of the elements of all streams.
+  /*!
+    The streams are read once, one after the other. Every element is
+    indexed, and the element following the first occurrence of every element
+    is stored as a markup definition, even if it lies in the next stream. The
+    positions of the streams are left unchanged.
+  */
+  void ConfigStreams::BuildIndex()
+  {
+    ClearIndex();
+
+    string previous, current;
+    bool first = true;
+    int Nstream = int(streams_.size());
+    for (int i = 0; i < Nstream; i++)
+      {
+        ConfigStream& stream = *streams_[i];
+        string markup_tags = stream.GetMarkupTags();
+        std::streampos initial_position = stream.tellg();
+        ifstream::iostate state = stream.rdstate();
+        stream.Rewind();
+
+        stream_element_.push_back(int(element_stream_.size()));
+        StringView element;
+        while (!(element = stream.GetElementView()).empty())
+          {
+            int index = int(element_stream_.size());
+            current = element.str();
+            element_stream_.push_back(i);
+            element_end_.push_back(std::streamoff(stream.tellg()));
+            occurrence_[current].push_back(index);
+            if (IsSection(current))
+              section_element_.push_back(index);
+            if (current.find_first_of(markup_tags) != string::npos)
+              {
+                markup_element_.push_back(index);
+                markup_raw_element_.push_back(current);
+              }
+
+            if (!first)
+              markup_definition_.insert(make_pair(previous,
+                                                  make_pair(current, i)));
+            previous.swap(current);
+            first = false;
+          }
+
+        stream.clear(state);
+        stream.seekg(initial_position);
+      }
+    stream_element_.push_back(int(element_stream_.size()));
+
+    // The value of the last element is empty.
+    if (!first)
+      markup_definition_.insert(make_pair(previous,
+                                          make_pair(string(""),
+                                                    Nstream - 1)));
+
+    index_built_ = true;
+  }
+
+  //! Discards the index of the elements and the markup values.
+  void ConfigStreams::ClearIndex()
+  {
+    index_built_ = false;
+    element_stream_.clear();
+    element_end_.clear();
+    stream_element_.clear();
+    occurrence_.clear();
+    section_element_.clear();
+    markup_element_.clear();
+    markup_raw_element_.clear();
+    markup_definition_.clear();
+    markup_value_.clear();
+    markup_section_end_.clear();
+  }
+
+  //! Returns the index of the next element to be read.
+  /*!
+    The index can only be determined if the current stream is at its
+    beginning or right after an element, and if the following streams are
+    at their beginning.
+    \return The index of the next element to be read, or -1 if it cannot be
+    determined.
+  */
+  int ConfigStreams::GetElementIndex()
+  {
+    if (!index_built_)
+      BuildIndex();
+
+    if (current_ == streams_.end())
+      return -1;
+
+    int current = int(current_ - streams_.begin());
+    int Nstream = int(streams_.size());
+    for (int i = current + 1; i < Nstream; i++)
+      if (!streams_[i]->good() || streams_[i]->tellg() != std::streampos(0))
+        return -1;
+
+    ConfigStream& stream = *streams_[current];
+    // A stream in a failed state has no more elements.
+    if (!stream.good())
+      return stream_element_[current + 1];
+
+    std::streamoff position = stream.tellg();
+    if (position == 0)
+      return stream_element_[current];
+
+    vector<std::streamoff>::const_iterator begin
+      = element_end_.begin() + stream_element_[current];
+    vector<std::streamoff>::const_iterator end
+      = element_end_.begin() + stream_element_[current + 1];
+    vector<std::streamoff>::const_iterator it
+      = lower_bound(begin, end, position);
+    if (it == end || *it != position)
+      return -1;
+    return int(it - element_end_.begin()) + 1;
+  }
+
+  //! Searches for an element, with the index.
+  /*!
+    The search follows 'GetElement': markups are replaced and the search
+    stops at the end of the current section, if any.
+    \param name the element to be found.
+    \return The index of the first occurrence of 'name' from the current
+    position, or -1 if the element is not found, if the search fails or if
+    the index cannot be used.
+  */
+  int ConfigStreams::FindElement(const string& name)
+  {
+    int first = GetElementIndex();
+    if (first == -1)
+      return -1;
+
+    int index = -1;
+    unordered_map<string, vector<int> >::const_iterator occurrence
+      = occurrence_.find(name);
+    if (occurrence != occurrence_.end())
+      {
+        vector<int>::const_iterator it
+          = lower_bound(occurrence->second.begin(), occurrence->second.end(),
+                        first);
+        if (it != occurrence->second.end())
+          index = *it;
+      }
+
+    int limit = index == -1 ? int(element_stream_.size()) : index;
+    if (!section_.empty())
+      {
+        vector<int>::const_iterator it
+          = lower_bound(section_element_.begin(), section_element_.end(),
+                        first);
+        // The element itself may be a section flag.
+        if (it != section_element_.end() && *it <= limit)
+          return -1;
+      }
+
+    // Elements with markups may be equal to 'name' after substitution.
+    for (vector<int>::const_iterator it
+           = lower_bound(markup_element_.begin(), markup_element_.end(),
+                         first);
+         it != markup_element_.end() && *it < limit; ++it)
+      {
+        string element;
+        try
+          {
+            int stream = element_stream_[*it];
+            element = SubstituteMarkups(markup_raw_element_
+                                        [it - markup_element_.begin()],
+                                        streams_[stream]->GetMarkupTags(),
+                                        "GetElement");
+          }
+        catch (...)
+          {
+            return -1;
+          }
+        if (element == "" || (!section_.empty() && IsSection(element)))
+          return -1;
+        if (element == name)
+          return *it;
+      }
+
+    return index;
+  }
+
+  //! Extracts elements up to a given element.
+  /*!
+    Equivalent to calling 'GetElement' until 'name' is found, but uses the
+    index of the elements whenever possible.
+    \param name the element to be found.
+    \return true if the element was found, in which case the get pointer is
+    exactly after it, false if the end of the streams was reached.
+    \note An exception is thrown if the end of the current section (if any)
+    is reached.
+  */
+  bool ConfigStreams::SkipToElement(const string& name)
+  {
+    int index = FindElement(name);
+    if (index != -1)
+      {
+        int stream = element_stream_[index];
+        for (; current_ != streams_.begin() + stream; ++current_)
+          SkipToEnd(int(current_ - streams_.begin()));
+        (*current_)->seekg(element_end_[index]);
+        return true;
+      }
+
+    string element;
+    while (this->GetElement(element) && element != name);
+    return element == name;
+  }
+
+  //! Selects the current section in a stream.
+  /*!
+    \param stream the stream.
+    \return true if the section was found in \a stream, false otherwise. In
+    the latter case, \a stream is rewound.
+  */
+  bool ConfigStreams::SelectSection(ConfigStream& stream)
+  {
+    if (stream.CheckSection(section_))
+      try
+        {
+          stream.SetSection(section_);
+          return true;
+        }
+      catch (...)
+        {
+        }
+    stream.Rewind();
+    stream.section_ = section_;
+    return false;
+  }
+
+  //! Rewinds all streams except the current stream.
+  /*!
+    After an element or a line is read, the other streams are at their
+    beginning, so that a read running past the end of the current stream
+    continues from the beginning of the next stream, even after
+    'SetSection' or 'Find' moved back to a previous stream.
+  */
+  void ConfigStreams::RewindOthers()
+  {
+    for (vector<ConfigStream*>::iterator it = streams_.begin();
+         it != streams_.end(); ++it)
+      if (it != current_)
+        (*it)->Rewind();
+  }
+
+  //! Returns the first section flag that stops a search in a stream.
+  /*!
+    \param stream index of the stream.
+    \param begin index of the element where the search starts.
+    \return The index of the first section flag from 'begin' in the stream,
+    if a section is selected in the stream, or the index of the element
+    following the last element of the stream otherwise.
+  */
+  int ConfigStreams::SectionLimit(int stream, int begin) const
+  {
+    int end = stream_element_[stream + 1];
+    if (streams_[stream]->section_.empty())
+      return end;
+    vector<int>::const_iterator it
+      = lower_bound(section_element_.begin(), section_element_.end(), begin);
+    return it == section_element_.end() ? end : min(*it, end);
+  }
+
+  //! Extracts all remaining elements of a stream.
+  /*!
+    The stream is left in the state it would have after a complete read.
+    \param stream index of the stream.
+  */
+  void ConfigStreams::SkipToEnd(int stream)
+  {
+    ConfigStream& config_stream = *streams_[stream];
+    int last = stream_element_[stream + 1] - 1;
+    if (config_stream.good() && last >= stream_element_[stream]
+        && config_stream.tellg() < element_end_[last])
+      config_stream.seekg(element_end_[last]);
+    while (!config_stream.GetElementView().empty());
+  }
+
+  //! Throws an exception stating that the end of the section was reached.
+  void ConfigStreams::ThrowEndOfSection() const
+  {
+    string message = string("End of section \"") + section_
+      + string("\" has been reached in ") + FileNames() + ".";
+    if (searching_ != "")
+      message += string("\nUnable to find \"")
+        + this->searching_ + string("\".");
+    throw message;
+  }
+
+
+  ////////////////////
+  // CONFIGSNAPSHOT //
+  ////////////////////
+
+  //! Default constructor.
+  /*! Nothing is performed.
+   */
+  ConfigSnapshot::ConfigSnapshot():
+    markup_tags_("<>$"), section_("")
+  {
+  }
+
+  //! Main constructor.
+  /*! Builds the snapshot of a configuration stream.
+    \param stream the configuration stream. Its position is left unchanged.
+  */
+  ConfigSnapshot::ConfigSnapshot(ConfigStream& stream):
+    section_("")
+  {
+    Build(stream);
+  }
+
+  //! Constructor.
+  /*! Opens a configuration file and builds its snapshot.
+    \param file_name file to be read.
+    \param comments characters that denote a comment line.
+    \param delimiters characters considered as delimiters.
+    \param markup_tags markup tags.
+  */
+  ConfigSnapshot::ConfigSnapshot(string file_name, string comments,
+                                 string delimiters, string markup_tags):
+    section_("")
+  {
+    ConfigStream stream(file_name, comments, delimiters, markup_tags);
+    Build(stream);
+  }
+
+  //! Builds the snapshot of a configuration stream.
+  /*!
+    The file of the stream is read once, with the comments, the delimiters
+    and the markup tags of the stream, into a 'ConfigView'.
+    \param stream the configuration stream. Its position is left unchanged.
+    \note The current section is unset.
+  */
+  void ConfigSnapshot::Build(ConfigStream& stream)
+  {
+    markup_tags_ = stream.GetMarkupTags();
+    section_ = "";
+
+    ConfigStreams streams(stream.GetFileName());
+    ConfigStream& copy = *streams.GetStreams()[0];
+    copy.SetComments(stream.GetComments());
+    copy.SetDelimiters(stream.GetDelimiters());
+    copy.SetMarkupTags(markup_tags_);
+
+    view_.Build(streams);
+  }
+
+  //! Deselects the section.
+  /*!
+    Deselects the section (this is equivalent to SetSection("")).
+  */
+  void ConfigSnapshot::NoSection()
+  {
+    section_ = "";
+  }
+
+  //! Sets the current section.
+  /*!
+    \param section current section.
+  */
+  void ConfigSnapshot::SetSection(string section)
+  {
+    view_.Register(section);
+    if (section != "" && view_.occurrence_.count(section) == 0)
+      throw string("Error in ConfigSnapshot::SetSection: section \"")
+        + section + string("\" was not found in ") + view_.file_names_
+        + ".";
+    section_ = section;
+  }
+
+  //! Returns the current section.
+  /*!
+    \return The current section.
+  */
+  string ConfigSnapshot::GetSection() const
+  {
+    return section_;
+  }
+
+  //! Returns the name of the file that was read.
+  /*!
+    \return The name of the file that was read.
+  */
+  string ConfigSnapshot::GetFileName() const
+  {
+    return view_.file_name_.empty() ? "" : view_.file_name_[0];
+  }
+
+  //! Returns the markup tags.
+  /*!
+    \return The markup tags.
+  */
+  string ConfigSnapshot::GetMarkupTags() const
+  {
+    return markup_tags_;
+  }
+
+  //! Returns the number of elements in the file.
+  /*!
+    \return The number of elements in the file.
+  */
+  int ConfigSnapshot::GetNelement() const
+  {
+    return view_.GetNelement();
+  }
+
+  //! Checks whether a given variable is found.
+  /*!
+    \param name the name of the variable.
+    \return true if the variable is found in the current section (or in the
+    file if no section is selected), false otherwise.
+  */
+  bool ConfigSnapshot::CheckValue(string name) const
+  {
+    view_.Register(name);
+    return FindField(name) != -1;
+  }
+
+  //! Returns the position of a given variable in the file.
+  /*!
+    \param name the name of the variable.
+    \return The position of the variable name in the file.
+  */
+  std::streampos ConfigSnapshot::GetPosition(string name) const
+  {
+    int index = FindField(name);
+    if (index == -1)
+      throw string("Error in ConfigSnapshot::GetPosition: \"")
+        + name + string("\" not found in ") + view_.file_names_ + ".";
+    return view_.position_[index];
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the
+    variable name.
+    \param name the name of the variable.
+    \return the value of the variable.
+  */
+  string ConfigSnapshot::GetValue(string name) const
+  {
+    view_.Register(name);
+
+    int index = FindField(name);
+    if (index == -1 && section_ != "")
+      throw string("Error in ConfigSnapshot::GetValue: \"") + name
+        + string("\" not found in section \"") + section_
+        + string("\" of ") + view_.file_names_ + ".";
+    if (index == -1)
+      throw string("Error in ConfigSnapshot::GetValue: \"")
+        + name + string("\" not found in ") + view_.file_names_ + ".";
+
+    index++;
+    if (index >= view_.GetNelement())
+      throw string("Error in ConfigSnapshot::GetValue: ")
+        + string("unable to get a value for \"") + name + string("\" in ")
+        + view_.file_names_ + ".";
+
+    const string& element = view_.GetElement(index);
+    if (section_ != "" && view_.IsSectionEnd(index))
+      throw string("Error in ConfigSnapshot::GetValue: ")
+        + string("unable to get a value for \"") + name + string("\" in ")
+        + view_.file_names_ + ".";
+
+    return element;
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string): the snapshot has no position.
+    \param name the name of the variable.
+    \return the value associated with the variable.
+  */
+  string ConfigSnapshot::PeekValue(string name) const
+  {
+    return GetValue(name);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the (numerical) value of a given variable, i.e. the number following
+    the variable name.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigSnapshot::GetValue(string name, T& value) const
+  {
+    view_.ConvertNumber("ConfigSnapshot::GetValue", name, GetValue(name),
+                        value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the integral value of a given variable, i.e. the integer following
+    the variable name.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  void ConfigSnapshot::GetValue(string name, int& value) const
+  {
+    view_.ConvertNumber("ConfigSnapshot::GetValue", name, GetValue(name),
+                        value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, T&): the snapshot has no position.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigSnapshot::PeekValue(string name, T& value) const
+  {
+    GetValue(name, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the (numerical) value of a given variable, i.e. the number following
+    the variable name.
+    \param name the name of the variable.
+    \param min the minimum value that the variable should take.
+    \param max the maximum value that the variable should take.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigSnapshot::GetValue(string name, T min, T max, T& value) const
+  {
+    GetValue(name, value);
+    view_.CheckRange("ConfigSnapshot::GetValue", name, min, max, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, T, T, T&): the snapshot has no position.
+    \param name the name of the variable.
+    \param min the minimum value that the variable should take.
+    \param max the maximum value that the variable should take.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigSnapshot::PeekValue(string name, T min, T max, T& value) const
+  {
+    GetValue(name, min, max, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the (numerical) value of a given variable, i.e. the number following
+    the variable name. This methods also checks that the value meets given
+    constraints.
+    \param name the name of the variable.
+    \param constraint the list of constraints. The constraints are delimited
+    by |. The supported constraints are: positive, strictly positive,
+    negative, strictly negative, non zero, integer, > x, >= x, < x, <= x, != x
+    y z, = x y z.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigSnapshot::GetValue(string name, string constraint,
+                                T& value) const
+  {
+    GetValue(name, value);
+    view_.CheckConstraints("ConfigSnapshot::GetValue", name, constraint,
+                           value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, string, T&): the snapshot has no position.
+    \param name the name of the variable.
+    \param constraint the list of constraints.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigSnapshot::PeekValue(string name, string constraint,
+                                 T& value) const
+  {
+    GetValue(name, constraint, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the
+    variable name.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  void ConfigSnapshot::GetValue(string name, string& value) const
+  {
+    value = GetValue(name);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, string&): the snapshot has no position.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  void ConfigSnapshot::PeekValue(string name, string& value) const
+  {
+    value = GetValue(name);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the
+    variable name. In addition, this method checks that the value is in an
+    acceptable list of values.
+    \param name the name of the variable.
+    \param accepted list of accepted values.
+    \param value value associated with the variable.
+    \param delimiter delimiter in \a accepted. Default: |.
+  */
+  void ConfigSnapshot::GetValue(string name, string accepted, string& value,
+                                string delimiter = "|") const
+  {
+    GetValue(name, value);
+    view_.CheckAccepted("ConfigSnapshot::GetValue", name, value, accepted,
+                        delimiter);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, string, string&, string): the snapshot has no
+    position.
+    \param name the name of the variable.
+    \param accepted list of accepted values.
+    \param value value associated with the variable.
+    \param delimiter delimiter in \a accepted. Default: |.
+  */
+  void ConfigSnapshot::PeekValue(string name, string accepted, string& value,
+                                 string delimiter = "|") const
+  {
+    GetValue(name, accepted, value, delimiter);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the
+    variable name.
+    \param name the name of the variable.
+    \param value boolean associated with the variable.
+  */
+  void ConfigSnapshot::GetValue(string name, bool& value) const
+  {
+    convert(GetValue(name), value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, bool&): the snapshot has no position.
+    \param name the name of the variable.
+    \param value boolean associated with the variable.
+  */
+  void ConfigSnapshot::PeekValue(string name, bool& value) const
+  {
+    GetValue(name, value);
+  }
+
+  //! Finds a variable in the current section.
+  /*!
+    Only the first occurrence of the section flag is considered, since this
+    is where 'ConfigStream::SetSection' goes. The section ends at the next
+    section flag. A section that is not a section flag holds no variable.
+    \param name the name of the variable.
+    \return The index of the first occurrence of \a name in the current
+    section (or in the file if no section is selected), or -1 if \a name is
+    not found.
+  */
+  int ConfigSnapshot::FindField(const string& name) const
+  {
+    unordered_map<string, vector<int> >::const_iterator occurrence
+      = view_.occurrence_.find(name);
+    if (occurrence == view_.occurrence_.end())
+      return -1;
+    if (section_ == "")
+      return occurrence->second[0];
+    if (!view_.IsSection(section_))
+      return -1;
+
+    int begin = view_.occurrence_.find(section_)->second[0] + 1;
+    vector<int>::const_iterator end
+      = lower_bound(view_.section_element_.begin(),
+                    view_.section_element_.end(), begin);
+    vector<int>::const_iterator it
+      = lower_bound(occurrence->second.begin(), occurrence->second.end(),
+                    begin);
+    if (it == occurrence->second.end()
+        || (end != view_.section_element_.end() && *it >= *end))
+      return -1;
+    return *it;
+  }
+
+
+  ////////////////
+  // CONFIGVIEW //
+  ////////////////
+
+  //! Default constructor.
+  /*! Nothing is performed: the view is empty.
+   */
+  ConfigView::ConfigView()
+  {
+  }
+
+  //! Main constructor.
+  /*! Builds the view of configuration streams.
+    \param streams the configuration streams. Their positions are left
+    unchanged.
+  */
+  ConfigView::ConfigView(ConfigStreams& streams)
+  {
+    Build(streams);
+  }
+
+  //! Builds the view of configuration streams.
+  /*!
+    The index of the elements of the streams is built if needed (or loaded
+    with 'ConfigStreams::LoadCache' beforehand), and the markups of all
+    elements are replaced. Errors in markups are kept, and raised when the
+    elements are read.
+    \param streams the configuration streams. Their positions are left
+    unchanged.
+  */
+  void ConfigView::Build(ConfigStreams& streams)
+  {
+    if (!streams.index_built_)
+      streams.BuildIndex();
+
+    file_name_.clear();
+    delimiters_.clear();
+    for (int i = 0; i < int(streams.streams_.size()); i++)
+      {
+        file_name_.push_back(streams.streams_[i]->GetFileName());
+        delimiters_.push_back(streams.streams_[i]->GetDelimiters());
+      }
+    file_names_ = streams.FileNames();
+
+    occurrence_ = streams.occurrence_;
+    section_element_ = streams.section_element_;
+    markup_element_ = streams.markup_element_;
+
+    element_.assign(streams.element_stream_.size(), "");
+    for (unordered_map<string, vector<int> >::const_iterator it
+           = occurrence_.begin(); it != occurrence_.end(); ++it)
+      for (int i = 0; i < int(it->second.size()); i++)
+        element_[it->second[i]] = it->first;
+
+    int Nelement = int(element_.size());
+    position_.resize(Nelement);
+    for (int i = 0; i < Nelement; i++)
+      position_[i] = streams.element_end_[i]
+        - std::streamoff(element_[i].size());
+
+    int Nmarkup = int(markup_element_.size());
+    markup_error_.assign(Nmarkup, "");
+    markup_section_end_.assign(Nmarkup, false);
+    for (int i = 0; i < Nmarkup; i++)
+      {
+        int index = markup_element_[i];
+        bool section_end = false;
+        try
+          {
+            int stream = streams.element_stream_[index];
+            element_[index]
+              = streams.SubstituteMarkups(element_[index],
+                                          streams.streams_[stream]
+                                          ->GetMarkupTags(),
+                                          "GetElement", &section_end);
+          }
+        catch (string& error)
+          {
+            markup_error_[i] = error;
+          }
+        markup_section_end_[i] = section_end || element_[index] == ""
+          || streams.IsSection(element_[index]);
+      }
+  }
+
+  //! Returns the names of the files.
+  /*!
+    \return The names of the files, in a string meant for messages.
+  */
+  string ConfigView::GetFileNames() const
+  {
+    return file_names_;
+  }
+
+  //! Returns the number of elements in the files.
+  /*!
+    \return The number of elements in the files.
+  */
+  int ConfigView::GetNelement() const
+  {
+    return int(element_.size());
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the
+    first occurrence of the variable name in the files.
+    \param name the name of the variable.
+    \return the value of the variable.
+  */
+  string ConfigView::GetValue(string name) const
+  {
+    ConfigCursor cursor(*this);
+    return cursor.GetValue(name);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string): the view has no position.
+    \param name the name of the variable.
+    \return the value of the variable.
+  */
+  string ConfigView::PeekValue(string name) const
+  {
+    return GetValue(name);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the
+    first occurrence of the variable name in the files.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigView::GetValue(string name, T& value) const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, T&): the view has no position.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigView::PeekValue(string name, T& value) const
+  {
+    GetValue(name, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the (numerical) value of a given variable, i.e. the number following
+    the first occurrence of the variable name in the files.
+    \param name the name of the variable.
+    \param min the minimum value that the variable should take.
+    \param max the maximum value that the variable should take.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigView::GetValue(string name, T min, T max, T& value) const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, min, max, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, T, T, T&): the view has no position.
+    \param name the name of the variable.
+    \param min the minimum value that the variable should take.
+    \param max the maximum value that the variable should take.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigView::PeekValue(string name, T min, T max, T& value) const
+  {
+    GetValue(name, min, max, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the (numerical) value of a given variable, i.e. the number following
+    the first occurrence of the variable name in the files. This methods
+    also checks that the value meets given constraints.
+    \param name the name of the variable.
+    \param constraint the list of constraints. The constraints are delimited
+    by |. The supported constraints are: positive, strictly positive,
+    negative, strictly negative, non zero, integer, > x, >= x, < x, <= x, != x
+    y z, = x y z.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigView::GetValue(string name, string constraint, T& value) const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, constraint, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, string, T&): the view has no position.
+    \param name the name of the variable.
+    \param constraint the list of constraints.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigView::PeekValue(string name, string constraint, T& value) const
+  {
+    GetValue(name, constraint, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the
+    first occurrence of the variable name in the files. In addition, this
+    method checks that the value is in an acceptable list of values.
+    \param name the name of the variable.
+    \param accepted list of accepted values.
+    \param value value associated with the variable.
+    \param delimiter delimiter in \a accepted. Default: |.
+  */
+  void ConfigView::GetValue(string name, string accepted, string& value,
+                            string delimiter = "|") const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, accepted, value, delimiter);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Same as GetValue(string, string, string&, string): the view has no
+    position.
+    \param name the name of the variable.
+    \param accepted list of accepted values.
+    \param value value associated with the variable.
+    \param delimiter delimiter in \a accepted. Default: |.
+  */
+  void ConfigView::PeekValue(string name, string accepted, string& value,
+                             string delimiter = "|") const
+  {
+    GetValue(name, accepted, value, delimiter);
+  }
+
+  //! Searches for an element with markups.
+  /*!
+    \param index the index of an element.
+    \return The position of \a index in 'markup_element_', or -1 if the
+    element has no markup.
+  */
+  int ConfigView::FindMarkup(int index) const
+  {
+    vector<int>::const_iterator it = lower_bound(markup_element_.begin(),
+                                                 markup_element_.end(),
+                                                 index);
+    if (it == markup_element_.end() || *it != index)
+      return -1;
+    return int(it - markup_element_.begin());
+  }
+
+  //! Registers a field searched for in the files, in debug mode.
+  /*!
+    \param name the name of the field.
+  */
+  void ConfigView::Register(const string& name) const
+  {
+#ifdef TALOS_DEBUG
+    for (int i = 0; i < int(file_name_.size()); i++)
+      SearchScope::AddToRegister(file_name_[i], delimiters_[i], name);
+#else
+    (void) name;
+#endif
+  }
+
+  //! Returns an element.
+  /*!
+    \param index the index of the element.
+    \return The element, with its markups replaced. If its markups could not
+    be replaced, the error is thrown.
+  */
+  const string& ConfigView::GetElement(int index) const
+  {
+    int markup = FindMarkup(index);
+    if (markup != -1 && !markup_error_[markup].empty())
+      throw markup_error_[markup];
+    return element_[index];
+  }
+
+  //! Checks whether an element ends a section.
+  /*!
+    \param index the index of the element.
+    \return True if the element is a section flag, or if one of its markups
+    is empty or reaches the end of a section, false otherwise.
+  */
+  bool ConfigView::IsSectionEnd(int index) const
+  {
+    int markup = FindMarkup(index);
+    if (markup != -1)
+      return markup_section_end_[markup];
+    return IsSection(element_[index]);
+  }
+
+  //! Checks whether a string is a section flag.
+  /*!
+    \param str string to be tested.
+    \return True if 'str' is a section flag, false otherwise.
+  */
+  bool ConfigView::IsSection(const string& str) const
+  {
+    return !str.empty() && str[0] == '[' && str[str.size() - 1] == ']';
+  }
+
+  //! Converts the value of a variable to a number.
+  /*!
+    \param function name of the calling method, for error messages.
+    \param name the name of the variable.
+    \param element the value of the variable.
+    \param value (output) the number.
+  */
+  template <class T>
+  void ConfigView::ConvertNumber(const string& function, const string& name,
+                                 const string& element, T& value) const
+  {
+    if (!is_num(element, value))
+      throw string("Error in ") + function + ": the value of \"" + name
+        + string("\" in ") + file_names_ + string(" is \"") + element
+        + "\", but it should be a number.";
+  }
+
+  //! Converts the value of a variable to an integer.
+  /*!
+    \param function name of the calling method, for error messages.
+    \param name the name of the variable.
+    \param element the value of the variable.
+    \param value (output) the integer.
+  */
+  void ConfigView::ConvertNumber(const string& function, const string& name,
+                                 const string& element, int& value) const
+  {
+    if (!is_integer(element))
+      throw string("Error in ") + function + ": the value of \"" + name
+        + string("\" in ") + file_names_ + string(" is \"") + element
+        + "\", but it should be an integer.";
+
+    value = to_num<int>(element);
+  }
+
+  //! Checks that the value of a variable is in a given range.
+  /*!
+    \param function name of the calling method, for error messages.
+    \param name the name of the variable.
+    \param min the minimum value that the variable should take.
+    \param max the maximum value that the variable should take.
+    \param value the value to be checked.
+  */
+  template <class T>
+  void ConfigView::CheckRange(const string& function, const string& name,
+                              T min, T max, T value) const
+  {
+    if (value < min || value > max)
+      throw string("Error in ") + function + ": the value of \"" + name
+        + string("\" in ") + file_names_ + " is " + to_str(value)
+        + " but it should be in [" + to_str(min) + ", " + to_str(max)
+        + "].";
+  }
+
+  //! Checks that the value of a variable meets given constraints.
+  /*!
+    \param function name of the calling method, for error messages.
+    \param name the name of the variable.
+    \param constraints the list of constraints.
+    \param value the value to be checked.
+  */
+  template <class T>
+  void ConfigView::CheckConstraints(const string& function,
+                                    const string& name,
+                                    const string& constraints,
+                                    T value) const
+  {
+    if (!satisfies_constraint(value, constraints))
+      throw string("Error in ") + function + ": the value of \"" + name
+        + string("\" in ") + file_names_ + " is " + to_str(value)
+        + " but it should satisfy the following constraint(s):\n"
+        + ConstraintSet<T>(constraints).Show();
+  }
+
+  //! Checks that a value is in a given list of accepted values.
+  /*!
+    \param function name of the calling method, for error messages.
+    \param name the name of the entry with value \a value.
+    \param value the value to be checked.
+    \param accepted the list of accepted values.
+    \param delimiter delimiter in \a accepted.
+  */
+  void ConfigView::CheckAccepted(const string& function, const string& name,
+                                 const string& value, const string& accepted,
+                                 const string& delimiter) const
+  {
+    vector<string> accepted_list = split(accepted, delimiter);
+    int i = 0;
+    while (i < int(accepted_list.size()) && trim(accepted_list[i]) != value)
+      i++;
+    if (i == int(accepted_list.size()))
+      {
+        string list = "[";
+        for (i = 0; i < int(accepted_list.size()) - 1; i++)
+          list += trim(accepted_list[i]) + " " + delimiter[0] + " ";
+        if (accepted_list.size() != 0)
+          list += trim(accepted_list[accepted_list.size() - 1]) + "]";
+        throw string("Error in ") + function + ": the value of \"" + name
+          + string("\" in ") + file_names_ + " is \"" + value
+          + "\" but it should be in " + list + ".";
+      }
+  }
+
+
+  //////////////////
+  // CONFIGCURSOR //
+  //////////////////
+
+  //! Main constructor.
+  /*! The cursor is at the beginning of the view, with no section.
+    \param view the view to be read. It must outlive the cursor.
+  */
+  ConfigCursor::ConfigCursor(const ConfigView& view):
+    view_(&view), position_(0), section_("")
+  {
+  }
+
+  //! Returns the view read by the cursor.
+  /*!
+    \return The view read by the cursor.
+  */
+  const ConfigView& ConfigCursor::GetView() const
+  {
+    return *view_;
+  }
+
+  //! Deselects the section.
+  /*!
+    Deselects the section (this is equivalent to SetSection("")) and goes
+    back to the beginning of the view.
+  */
+  void ConfigCursor::NoSection()
+  {
+    section_ = "";
+    position_ = 0;
+  }
+
+  //! Sets the current section.
+  /*!
+    The cursor is put right after the first occurrence of the section flag.
+    \param section current section.
+  */
+  void ConfigCursor::SetSection(string section)
+  {
+    if (section == "")
+      {
+        NoSection();
+        return;
+      }
+
+    view_->Register(section);
+    unordered_map<string, vector<int> >::const_iterator occurrence
+      = view_->occurrence_.find(section);
+    if (occurrence == view_->occurrence_.end()
+        || !view_->IsSection(section))
+      throw string("Error in ConfigCursor::SetSection: section \"")
+        + section + string("\" was not found in ")
+        + view_->file_names_ + ".";
+
+    section_ = section;
+    position_ = occurrence->second[0] + 1;
+  }
+
+  //! Returns the current section.
+  /*!
+    \return The current section.
+  */
+  string ConfigCursor::GetSection() const
+  {
+    return section_;
+  }
+
+  //! Goes back to the beginning of the view.
+  /*!
+    \return A reference to 'this'.
+  */
+  ConfigCursor& ConfigCursor::Rewind()
+  {
+    position_ = 0;
+    return *this;
+  }
+
+  //! Sets the position of the cursor after a given element.
+  /*!
+    Sets the position of the cursor exactly after a given element, before
+    markups are replaced. If a section is selected, the search stops at the
+    next section flag.
+    \param element the element to be found.
+    \return true if the element was found. An exception is thrown otherwise.
+  */
+  bool ConfigCursor::Find(string element)
+  {
+    view_->Register(element);
+
+    int Nelement = int(view_->element_.size());
+    int index = Nelement;
+    unordered_map<string, vector<int> >::const_iterator occurrence
+      = view_->occurrence_.find(element);
+    if (occurrence != view_->occurrence_.end())
+      {
+        vector<int>::const_iterator it
+          = lower_bound(occurrence->second.begin(), occurrence->second.end(),
+                        position_);
+        if (it != occurrence->second.end())
+          index = *it;
+      }
+
+    if (!section_.empty())
+      {
+        vector<int>::const_iterator it
+          = lower_bound(view_->section_element_.begin(),
+                        view_->section_element_.end(), position_);
+        if (it != view_->section_element_.end() && *it <= index)
+          {
+            position_ = *it + 1;
+            throw string("Error in ConfigCursor::Find: end of section \"")
+              + section_ + string("\" has been reached in ")
+              + view_->file_names_ + string(".\nUnable to find \"")
+              + element + "\".";
+          }
+        if (index == Nelement)
+          {
+            position_ = Nelement;
+            throw string("Error in ConfigCursor::Find: end of section \"")
+              + section_ + string("\" has been reached in ")
+              + view_->file_names_ + string(".\nUnable to find \"")
+              + element + "\".";
+          }
+      }
+
+    if (index == Nelement)
+      {
+        position_ = Nelement;
+        throw string("Error in ConfigCursor::Find: \"")
+          + element + string("\" not found in ")
+          + view_->file_names_ + ".";
+      }
+
+    position_ = index + 1;
+    return true;
+  }
+
+  //! Sets the position of the cursor after a given element.
+  /*!
+    Sets the position of the cursor exactly after a given element, searched
+    from the beginning of the view. The section is deselected.
+    \param element the element to be found.
+    \return true if the element was found. An exception is thrown otherwise.
+  */
+  bool ConfigCursor::FindFromBeginning(string element)
+  {
+    NoSection();
+    return Find(element);
+  }
+
+  //! Returns the next element.
+  /*!
+    \return The next element, with its markups replaced, or an empty string
+    at the end of the view.
+  */
+  string ConfigCursor::GetElement()
+  {
+    return ReadElement("");
+  }
+
+  //! Gets the next element.
+  /*!
+    \param element (output) the next element.
+    \return true if an element was read, false at the end of the view.
+  */
+  template <class T>
+  bool ConfigCursor::GetElement(T& element)
+  {
+    string str = this->GetElement();
+    convert(str, element);
+
+    return (str != "");
+  }
+
+  //! Returns the next element without moving the cursor.
+  /*!
+    \return The next element.
+  */
+  string ConfigCursor::PeekElement() const
+  {
+    ConfigCursor cursor(*this);
+    return cursor.GetElement();
+  }
+
+  //! Gets the next element without moving the cursor.
+  /*!
+    \param element (output) the next element.
+    \return true if an element was read, false at the end of the view.
+  */
+  template <class T>
+  bool ConfigCursor::PeekElement(T& element) const
+  {
+    ConfigCursor cursor(*this);
+    return cursor.GetElement(element);
+  }
+
+  //! Skips elements.
+  /*!
+    \param nb number of elements to be skipped.
+  */
+  void ConfigCursor::SkipElements(int nb)
+  {
+    for (int i = 0; i < nb; i++)
+      this->GetElement();
+  }
+
+  //! Returns the next number.
+  /*!
+    Elements that are not numbers are skipped.
+    \return The next number, or 0 if no number is found.
+  */
+  double ConfigCursor::GetNumber()
+  {
+    string element;
+    double number = 0.;
+    while (this->GetElement(element) && !is_num(element, number));
+
+    return number;
+  }
+
+  //! Gets the next number.
+  /*!
+    Elements that are not numbers are skipped.
+    \param number (output) the next number, or 0 if no number is found.
+    \return true if a number was found, false otherwise.
+  */
+  template <class T>
+  bool ConfigCursor::GetNumber(T& number)
+  {
+    string element;
+    bool success;
+    while ((success = this->GetElement(element))
+           && !is_num(element, number));
+
+    if (!success)
+      number = T(0);
+
+    return success;
+  }
+
+  //! Returns the next number without moving the cursor.
+  /*!
+    \return The next number, or 0 if no number is found.
+  */
+  double ConfigCursor::PeekNumber() const
+  {
+    ConfigCursor cursor(*this);
+    return cursor.GetNumber();
+  }
+
+  //! Gets the next number without moving the cursor.
+  /*!
+    \param number (output) the next number, or 0 if no number is found.
+    \return true if a number was found, false otherwise.
+  */
+  template <class T>
+  bool ConfigCursor::PeekNumber(T& number) const
+  {
+    ConfigCursor cursor(*this);
+    return cursor.GetNumber(number);
+  }
+
+  //! Skips numbers.
+  /*!
+    \param nb number of numbers to be skipped.
+  */
+  void ConfigCursor::SkipNumbers(int nb)
+  {
+    for (int i = 0; i < nb; i++)
+      this->GetNumber();
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the next
+    occurrence of the variable name.
+    \param name the name of the variable.
+    \return the value of the variable.
+  */
+  string ConfigCursor::GetValue(string name)
+  {
+    if (!SkipToElement(name))
+      throw string("Error in ConfigCursor::GetValue: \"")
+        + name + string("\" not found in ") + view_->file_names_ + ".";
+
+    return this->GetElement();
+  }
+
+  //! Gets the value of a given variable without moving the cursor.
+  /*!
+    \param name the name of the variable.
+    \return the value of the variable.
+  */
+  string ConfigCursor::PeekValue(string name) const
+  {
+    ConfigCursor cursor(*this);
+    return cursor.GetValue(name);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the (numerical) value of a given variable, i.e. the element
+    following the next occurrence of the variable name.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigCursor::GetValue(string name, T& value)
+  {
+    if (!SkipToElement(name))
+      throw string("Error in ConfigCursor::GetValue: \"")
+        + name + string("\" not found in ") + view_->file_names_ + ".";
+    string element = ReadElement(name);
+    if (element == "")
+      throw string("Error in ConfigCursor::GetValue: unable to read value")
+        + string(" of \"") + name + string("\" in ") + view_->file_names_
+        + ".";
+    view_->ConvertNumber("ConfigCursor::GetValue", name, element, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the integral value of a given variable, i.e. the element following
+    the next occurrence of the variable name.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  void ConfigCursor::GetValue(string name, int& value)
+  {
+    if (!SkipToElement(name))
+      throw string("Error in ConfigCursor::GetValue: \"")
+        + name + string("\" not found in ") + view_->file_names_ + ".";
+    string element = ReadElement(name);
+    if (element == "")
+      throw string("Error in ConfigCursor::GetValue: unable to read value")
+        + string(" of \"") + name + string("\" in ") + view_->file_names_
+        + ".";
+    view_->ConvertNumber("ConfigCursor::GetValue", name, element, value);
+  }
+
+  //! Gets the value of a given variable without moving the cursor.
+  /*!
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigCursor::PeekValue(string name, T& value) const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the (numerical) value of a given variable, i.e. the element
+    following the next occurrence of the variable name.
+    \param name the name of the variable.
+    \param min the minimum value that the variable should take.
+    \param max the maximum value that the variable should take.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigCursor::GetValue(string name, T min, T max, T& value)
+  {
+    GetValue(name, value);
+    view_->CheckRange("ConfigCursor::GetValue", name, min, max, value);
+  }
+
+  //! Gets the value of a given variable without moving the cursor.
+  /*!
+    \param name the name of the variable.
+    \param min the minimum value that the variable should take.
+    \param max the maximum value that the variable should take.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigCursor::PeekValue(string name, T min, T max, T& value) const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, min, max, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the (numerical) value of a given variable, i.e. the element
+    following the next occurrence of the variable name. This methods also
+    checks that the value meets given constraints.
+    \param name the name of the variable.
+    \param constraint the list of constraints. The constraints are delimited
+    by |. The supported constraints are: positive, strictly positive,
+    negative, strictly negative, non zero, integer, > x, >= x, < x, <= x, != x
+    y z, = x y z.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigCursor::GetValue(string name, string constraint, T& value)
+  {
+    GetValue(name, value);
+    view_->CheckConstraints("ConfigCursor::GetValue", name, constraint,
+                            value);
+  }
+
+  //! Gets the value of a given variable without moving the cursor.
+  /*!
+    \param name the name of the variable.
+    \param constraint the list of constraints.
+    \param value value associated with the variable.
+  */
+  template <class T>
+  void ConfigCursor::PeekValue(string name, string constraint,
+                               T& value) const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, constraint, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the next
+    occurrence of the variable name.
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  void ConfigCursor::GetValue(string name, string& value)
+  {
+    if (!SkipToElement(name))
+      throw string("Error in ConfigCursor::GetValue: \"")
+        + name + string("\" not found in ") + view_->file_names_ + ".";
+
+    if (!this->GetElement(value))
+      throw string("Error in ConfigCursor::GetValue: ")
+        + string("unable to get a value for \"") + name + string("\" in ")
+        + view_->file_names_ + ".";
+  }
+
+  //! Gets the value of a given variable without moving the cursor.
+  /*!
+    \param name the name of the variable.
+    \param value value associated with the variable.
+  */
+  void ConfigCursor::PeekValue(string name, string& value) const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, value);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the next
+    occurrence of the variable name. In addition, this method checks that
+    the value is in an acceptable list of values.
+    \param name the name of the variable.
+    \param accepted list of accepted values.
+    \param value value associated with the variable.
+    \param delimiter delimiter in \a accepted. Default: |.
+  */
+  void ConfigCursor::GetValue(string name, string accepted, string& value,
+                              string delimiter = "|")
+  {
+    GetValue(name, value);
+    view_->CheckAccepted("ConfigCursor::GetValue", name, value, accepted,
+                         delimiter);
+  }
+
+  //! Gets the value of a given variable without moving the cursor.
+  /*!
+    \param name the name of the variable.
+    \param accepted list of accepted values.
+    \param value value associated with the variable.
+    \param delimiter delimiter in \a accepted. Default: |.
+  */
+  void ConfigCursor::PeekValue(string name, string accepted, string& value,
+                               string delimiter = "|") const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, accepted, value, delimiter);
+  }
+
+  //! Gets the value of a given variable.
+  /*!
+    Gets the value of a given variable, i.e. the element following the next
+    occurrence of the variable name.
+    \param name the name of the variable.
+    \param value boolean associated with the variable.
+  */
+  void ConfigCursor::GetValue(string name, bool& value)
+  {
+    if (!SkipToElement(name))
+      throw string("Error in ConfigCursor::GetValue: \"")
+        + name + string("\" not found in ") + view_->file_names_ + ".";
+
+    if (!this->GetElement(value))
+      throw string("Error in ConfigCursor::GetValue: ")
+        + string("unable to get a value for \"") + name + string("\" in ")
+        + view_->file_names_ + ".";
+  }
+
+  //! Gets the value of a given variable without moving the cursor.
+  /*!
+    \param name the name of the variable.
+    \param value boolean associated with the variable.
+  */
+  void ConfigCursor::PeekValue(string name, bool& value) const
+  {
+    ConfigCursor cursor(*this);
+    cursor.GetValue(name, value);
+  }
+
+  //! Moves the cursor right after the next occurrence of an element.
+  /*!
+    The search follows 'GetElement': markups are replaced and the search
+    stops at the end of the current section, if any.
+    \param name the element to be found.
+    \return true if the element was found, false if the end of the view was
+    reached (with no section selected).
+  */
+  bool ConfigCursor::SkipToElement(const string& name)
+  {
+    view_->Register(name);
+
+    const ConfigView& view = *view_;
+    int Nelement = int(view.element_.size());
+
+    int stop = Nelement;
+    unordered_map<string, vector<int> >::const_iterator occurrence
+      = view.occurrence_.find(name);
+    if (occurrence != view.occurrence_.end())
+      {
+        vector<int>::const_iterator it
+          = lower_bound(occurrence->second.begin(), occurrence->second.end(),
+                        position_);
+        if (it != occurrence->second.end())
+          stop = *it;
+      }
+
+    // The first section flag ends the search.
+    bool section_end = false;
+    if (!section_.empty())
+      {
+        vector<int>::const_iterator it
+          = lower_bound(view.section_element_.begin(),
+                        view.section_element_.end(), position_);
+        if (it != view.section_element_.end() && *it <= stop)
+          {
+            stop = *it;
+            section_end = true;
+          }
+      }
+
+    // Elements with markups may be equal to 'name', or end the search.
+    int markup = -1;
+    for (vector<int>::const_iterator it
+           = lower_bound(view.markup_element_.begin(),
+                         view.markup_element_.end(), position_);
+         it != view.markup_element_.end() && *it < stop; ++it)
+      {
+        int i = int(it - view.markup_element_.begin());
+        if (!view.markup_error_[i].empty()
+            || (!section_.empty() && view.markup_section_end_[i])
+            || view.element_[*it] == name)
+          {
+            stop = *it;
+            markup = i;
+            break;
+          }
+      }
+
+    if (stop == Nelement)
+      {
+        position_ = Nelement;
+        if (!section_.empty())
+          ThrowEndOfSection(name);
+        return false;
+      }
+
+    position_ = stop + 1;
+    if (markup != -1)
+      {
+        if (!view.markup_error_[markup].empty())
+          throw view.markup_error_[markup];
+        if (!section_.empty() && view.markup_section_end_[markup])
+          ThrowEndOfSection(name);
+      }
+    else if (section_end)
+      ThrowEndOfSection(name);
+
+    return true;
+  }
+
+  //! Returns the next element.
+  /*!
+    \param searching the element being searched for, if any, for error
+    messages.
+    \return The next element, with its markups replaced, or an empty string
+    at the end of the view.
+  */
+  string ConfigCursor::ReadElement(const string& searching)
+  {
+    if (position_ >= int(view_->element_.size()))
+      {
+        if (!section_.empty())
+          ThrowEndOfSection(searching);
+        return "";
+      }
+
+    int index = position_++;
+    const string& element = view_->GetElement(index);
+    if (!section_.empty() && view_->IsSectionEnd(index))
+      ThrowEndOfSection(searching);
+
+    return element;
+  }
+
+  //! Throws an exception stating that the end of the section was reached.
+  /*!
+    \param searching the element being searched for, if any.
+  */
+  void ConfigCursor::ThrowEndOfSection(const string& searching) const
+  {
+    string message = string("End of section \"") + section_
+      + string("\" has been reached in ") + view_->file_names_ + ".";
+    if (searching != "")
+      message += string("\nUnable to find \"") + searching + string("\".");
+    throw message;
+  }
+
 }  // namespace Talos.
 
 
@@ -31,6 +31,10 @@
 #include <sstream>
 #include <vector>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "String.hxx"
 
 
 namespace Talos
@@ -50,12 +54,111 @@ namespace Talos
   bool satisfies_constraint(T value, string constraint);
   string show_constraint(string constraint);
 
+#ifndef SWIG
+  //! List of constraints on a numerical value, parsed once.
+  /*!
+    The list is split and its bounds are converted when the object is
+    built. Checking a value then involves no parsing and no allocation. The
+    lists are shared through a cache, keyed by their text, for each type. At
+    most 64 lists are kept per type; other lists are parsed at each use.
+  */
+  template <class T>
+  class ConstraintSet
+  {
+  protected:
+    //! Kinds of constraints.
+    enum
+      {
+        unsupported, invalid, less_equal, less, greater_equal, greater,
+        different, equal, positive, strictly_positive, negative,
+        strictly_negative, non_zero, integer
+      };
+
+    //! Kind of each constraint.
+    vector<int> kind_;
+    //! Text of each constraint.
+    vector<string> expression_;
+    //! Numbers of each constraint, in text form.
+    vector<vector<string> > number_str_;
+    //! Numbers of each constraint.
+    vector<vector<T> > number_;
+    //! Position of the first invalid number of each constraint, or -1.
+    vector<int> invalid_;
+
+  public:
+    ConstraintSet(string constraint);
+
+    static const ConstraintSet<T>* Get(const string& constraint);
+
+    bool Satisfies(T value) const;
+    string Show() const;
+
+  private:
+    void ThrowInvalid(int i, string function) const;
+  };
+#endif
+
 #ifndef SWIG
   //! A scope opened when searching for a field.
   class SearchScope;
 #endif
 
+#ifndef SWIG
+  //! Read-only stream buffer over a memory-mapped file.
+  /*!
+    The whole file is in the get area, so that positioning in the stream is
+    a mere pointer update.
+  */
+  class MappedBuffer: public std::streambuf
+  {
+  protected:
+    //! Beginning of the mapped region.
+    char* data_;
+    //! Size of the mapped region.
+    size_t size_;
+    //! Is a file mapped?
+    bool mapped_;
+    //! Descriptor of the mapped file, kept open to check its size, or -1.
+    int descriptor_;
+
+  public:
+    MappedBuffer();
+    virtual ~MappedBuffer();
+
+    bool Map(string file_name);
+    void Unmap();
+    bool IsMapped() const;
+    bool HasChanged() const;
+
+    const char* Begin() const;
+    const char* Current() const;
+    const char* End() const;
+    void SetCurrent(const char* position);
+
+  protected:
+    virtual pos_type seekoff(off_type offset, std::ios_base::seekdir way,
+                             std::ios_base::openmode which);
+    virtual pos_type seekpos(pos_type position,
+                             std::ios_base::openmode which);
+    virtual std::streamsize showmanyc();
+
+  private:
+    MappedBuffer(const MappedBuffer&);
+    MappedBuffer& operator=(const MappedBuffer&);
+  };
+#endif
+
   //! Extended streams.
+  /*!
+    Regular files are memory-mapped (unless the macro 'TALOS_DISABLE_MMAP' is
+    defined), and the stream then reads directly from memory. Other files are
+    read through the file buffer of 'ifstream'.
+    \warning A mapped file must not be truncated by another process while the
+    stream reads it: reading the lost pages raises SIGBUS. If the size of the
+    file has changed when the stream is rewound, the stream goes back to the
+    file buffer. Define 'TALOS_DISABLE_MMAP' for files that other processes
+    may rewrite in place.
+  */
 #ifndef SWIG
   class ExtStream: public ifstream
 #else
@@ -74,6 +177,15 @@ namespace Talos
     string searching_;
 
 #ifndef SWIG
+    //! Buffer over the mapped file, if the file could be mapped.
+    MappedBuffer mapped_buffer_;
+    //! Buffer for the current line, if the file is not mapped.
+    string line_buffer_;
+    //! Is a character a delimiter?
+    bool is_delimiter_[256];
+    //! Is a character a comment character?
+    bool is_comment_[256];
+
     friend class SearchScope;
 #endif
 
@@ -104,6 +216,7 @@ namespace Talos
     void Open(string file_name, openmode mode = in);
 #endif
     void Close();
+    bool IsMapped() const;
 
     bool IsEmpty();
 
@@ -131,6 +244,9 @@ namespace Talos
     bool FindFromBeginning(string element);
 
     virtual string GetElement();
+#ifndef SWIG
+    StringView GetElementView();
+#endif
     template <class T>
     bool GetElement(T& element);
     template <class T>
@@ -147,6 +263,12 @@ namespace Talos
     template <class T>
     bool PeekNumber(T& number);
     void SkipNumbers(int nb);
+#ifndef SWIG
+    template <class T>
+    void GetNumbers(T* numbers, size_t N);
+    template <class T>
+    void GetNumbers(vector<T>& numbers);
+#endif
 
     string GetValue(string name);
     string PeekValue(string name);
@@ -180,6 +302,12 @@ namespace Talos
   protected:
     void CheckAccepted(string name, string value, string accepted,
                        string delimiter) const;
+    virtual bool SkipToElement(const string& element);
+    virtual void ClearCache();
+    void UpdateCharacterTables();
+    void Map();
+    void Unmap();
+    bool SkipMappedDiscarded();
   };
 
   //! Streams associated with configuration files.
@@ -189,6 +317,27 @@ namespace Talos
     string markup_tags_;
     string section_;
 
+    //! Element following the first occurrence of each element.
+    unordered_map<string, string> markup_definition_;
+    //! Has 'markup_definition_' been built?
+    bool markup_definition_built_;
+    //! Values of the markups already resolved.
+    unordered_map<string, string> markup_value_;
+    //! Resolved markups whose values go through an empty value or a section
+    //! flag.
+    unordered_set<string> markup_section_end_;
+    //! Markups being resolved, to detect circular definitions.
+    vector<string> markup_resolving_;
+
+    //! Have the positions of the section flags been computed?
+    bool section_position_built_;
+    //! Positions of the beginning of all section flags.
+    vector<std::streamoff> section_begin_;
+    //! Positions of the end of all section flags.
+    vector<std::streamoff> section_end_;
+    //! Position after the first occurrence of each section flag.
+    unordered_map<string, std::streamoff> section_position_;
+
   public:
     ConfigStream();
     ConfigStream(string file_name,
@@ -215,8 +364,24 @@ namespace Talos
     virtual string GetLine();
     virtual bool GetLine(string& line);
 
+  protected:
+    virtual bool SkipToElement(const string& element);
+    virtual void ClearCache();
+    string SubstituteMarkups(string element,
+                             string function = "GetElement",
+                             bool* section_end = NULL);
+    string GetMarkupValue(const string& markup, const string& function);
+    void BuildMarkupDefinitions();
+    void BuildSectionPositions();
+    bool SkipSection(const string& element);
+    void ThrowEndOfSection() const;
+
   private:
     bool IsSection(string str) const;
+#ifndef SWIG
+    bool IsSection(const StringView& str) const;
+#endif
+    bool CheckSection(const string& section);
 
     friend class ConfigStreams;
 #ifndef SWIG
@@ -236,9 +401,38 @@ namespace Talos
     //! Field currently searched.
     string searching_;
 
+    //! Has the index of the elements been built?
+    bool index_built_;
+    //! Index of the stream of each element.
+    vector<int> element_stream_;
+    //! Position of the end of each element in its stream.
+    vector<std::streamoff> element_end_;
+    //! Index of the first element of each stream, and number of elements.
+    vector<int> stream_element_;
+    //! Indices of the occurrences of each element.
+    unordered_map<string, vector<int> > occurrence_;
+    //! Indices of the section flags.
+    vector<int> section_element_;
+    //! Indices of the elements with markups.
+    vector<int> markup_element_;
+    //! Elements with markups.
+    vector<string> markup_raw_element_;
+
+    //! Element following the first occurrence of each element, with the
+    //! index of the stream it belongs to.
+    unordered_map<string, pair<string, int> > markup_definition_;
+    //! Values of the markups already resolved.
+    unordered_map<string, string> markup_value_;
+    //! Resolved markups whose values go through an empty value or a section
+    //! flag.
+    unordered_set<string> markup_section_end_;
+    //! Markups being resolved, to detect circular definitions.
+    vector<string> markup_resolving_;
+
 #ifndef SWIG
     friend class SearchScope;
 #endif
+    friend class ConfigView;
 
   public:
     ConfigStreams();
@@ -336,11 +530,275 @@ namespace Talos
     void GetValue(string name, bool& value);
     void PeekValue(string name, bool& value);
 
+    void SaveCache(string file_name);
+    bool LoadCache(string file_name);
+    bool UseCache(string file_name);
+
   private:
     bool IsSection(string str) const;
     string FileNames() const;
     void CheckAccepted(string name, string value, string accepted,
                        string delimiter) const;
+    bool GetCacheKey(string& key) const;
+    void SetSectionPositions();
+    string SubstituteMarkups(string element, const string& markup_tags,
+                             const string& function,
+                             bool* section_end = NULL);
+    string GetMarkupValue(const string& markup, const string& function);
+    void BuildIndex();
+    void ClearIndex();
+    int GetElementIndex();
+    int FindElement(const string& name);
+    bool SkipToElement(const string& name);
+    int SectionLimit(int stream, int begin) const;
+    bool SelectSection(ConfigStream& stream);
+    void RewindOthers();
+    void SkipToEnd(int stream);
+    void ThrowEndOfSection() const;
+  };
+
+  //! Read-only view of configuration files, shared between threads.
+  /*!
+    The view is built from 'ConfigStreams': the elements of all files are
+    stored in order, with their markups replaced, and indexed. The view is
+    never modified afterwards, so that any number of threads may read it
+    concurrently without locks. The search for a field always starts at the
+    beginning of the files. Each thread may read the files sequentially, or
+    within a section, through its own 'ConfigCursor'. The view is also the
+    table of 'ConfigSnapshot'.
+  */
+  class ConfigView
+  {
+  protected:
+    //! Names of the files.
+    vector<string> file_name_;
+    //! Delimiters of the files.
+    vector<string> delimiters_;
+    //! Names of the files, for error messages.
+    string file_names_;
+
+    //! Elements of the files, in order, with their markups replaced.
+    vector<string> element_;
+    //! Positions of the elements in their files.
+    vector<std::streampos> position_;
+    //! Indices of the occurrences of each element, before markups are
+    //! replaced.
+    unordered_map<string, vector<int> > occurrence_;
+    //! Indices of the section flags.
+    vector<int> section_element_;
+    //! Indices of the elements with markups.
+    vector<int> markup_element_;
+    //! Error raised when replacing the markups of each element with markups,
+    //! or an empty string.
+    vector<string> markup_error_;
+    //! Does each element with markups reach the end of a section?
+    vector<bool> markup_section_end_;
+
+    friend class ConfigCursor;
+    friend class ConfigSnapshot;
+
+  public:
+    ConfigView();
+    ConfigView(ConfigStreams& streams);
+
+    void Build(ConfigStreams& streams);
+
+    string GetFileNames() const;
+    int GetNelement() const;
+
+    string GetValue(string name) const;
+    string PeekValue(string name) const;
+
+    template <class T>
+    void GetValue(string name, T& value) const;
+    template <class T>
+    void PeekValue(string name, T& value) const;
+    template <class T>
+    void GetValue(string name, T min, T max, T& value) const;
+    template <class T>
+    void PeekValue(string name, T min, T max, T& value) const;
+    template <class T>
+    void GetValue(string name, string constraints, T& value) const;
+    template <class T>
+    void PeekValue(string name, string constraints, T& value) const;
+
+    void GetValue(string name, string accepted, string& value,
+                  string delimiter) const;
+    void PeekValue(string name, string accepted, string& value,
+                   string delimiter) const;
+
+  protected:
+    const string& GetElement(int index) const;
+    bool IsSectionEnd(int index) const;
+    bool IsSection(const string& str) const;
+    int FindMarkup(int index) const;
+    void Register(const string& name) const;
+
+    template <class T>
+    void ConvertNumber(const string& function, const string& name,
+                       const string& element, T& value) const;
+    void ConvertNumber(const string& function, const string& name,
+                       const string& element, int& value) const;
+    template <class T>
+    void CheckRange(const string& function, const string& name, T min, T max,
+                    T value) const;
+    template <class T>
+    void CheckConstraints(const string& function, const string& name,
+                          const string& constraints, T value) const;
+    void CheckAccepted(const string& function, const string& name,
+                       const string& value, const string& accepted,
+                       const string& delimiter) const;
+  };
+
+  //! Position of a reader in a 'ConfigView'.
+  /*!
+    A cursor holds a position and a section, and reads the elements of its
+    view as 'ConfigStreams' reads its files. Cursors are cheap to create and
+    to copy: each thread should use its own cursor.
+  */
+  class ConfigCursor
+  {
+  protected:
+    //! The view that is read.
+    const ConfigView* view_;
+    //! Index of the next element to be read.
+    int position_;
+    //! Current section.
+    string section_;
+
+  public:
+    ConfigCursor(const ConfigView& view);
+
+    const ConfigView& GetView() const;
+
+    void NoSection();
+    void SetSection(string section);
+    string GetSection() const;
+
+    ConfigCursor& Rewind();
+
+    bool Find(string element);
+    bool FindFromBeginning(string element);
+
+    string GetElement();
+    template <class T>
+    bool GetElement(T& element);
+    string PeekElement() const;
+    template <class T>
+    bool PeekElement(T& element) const;
+    void SkipElements(int nb);
+
+    double GetNumber();
+    template <class T>
+    bool GetNumber(T& number);
+    double PeekNumber() const;
+    template <class T>
+    bool PeekNumber(T& number) const;
+    void SkipNumbers(int nb);
+
+    string GetValue(string name);
+    string PeekValue(string name) const;
+
+    template <class T>
+    void GetValue(string name, T& value);
+    void GetValue(string name, int& value);
+    template <class T>
+    void PeekValue(string name, T& value) const;
+    template <class T>
+    void GetValue(string name, T min, T max, T& value);
+    template <class T>
+    void PeekValue(string name, T min, T max, T& value) const;
+    template <class T>
+    void GetValue(string name, string constraints, T& value);
+    template <class T>
+    void PeekValue(string name, string constraints, T& value) const;
+
+    void GetValue(string name, string& value);
+    void PeekValue(string name, string& value) const;
+    void GetValue(string name, string accepted, string& value,
+                  string delimiter);
+    void PeekValue(string name, string accepted, string& value,
+                   string delimiter) const;
+
+    void GetValue(string name, bool& value);
+    void PeekValue(string name, bool& value) const;
+
+  private:
+    string ReadElement(const string& searching);
+    bool SkipToElement(const string& name);
+    void ThrowEndOfSection(const string& searching) const;
+  };
+
+  //! Indexed snapshot of a configuration file.
+  /*!
+    The file is tokenized once into a 'ConfigView', and every field is then
+    retrieved through its index instead of a scan of the stream. The search
+    for a field always starts at the beginning of the current section (or at
+    the beginning of the file if no section is selected).
+  */
+  class ConfigSnapshot
+  {
+  protected:
+    //! Elements of the file.
+    ConfigView view_;
+    //! Markup tags.
+    string markup_tags_;
+
+    //! Current section.
+    string section_;
+
+  public:
+    ConfigSnapshot();
+    ConfigSnapshot(ConfigStream& stream);
+    ConfigSnapshot(string file_name,
+                   string comments = "#%",
+                   string delimiters = " \t:=|\n,;\r\x0D\x0A",
+                   string markup_tags = "<>$");
+
+    void Build(ConfigStream& stream);
+
+    void NoSection();
+    void SetSection(string section);
+    string GetSection() const;
+
+    string GetFileName() const;
+    string GetMarkupTags() const;
+    int GetNelement() const;
+
+    bool CheckValue(string name) const;
+#ifndef SWIG
+    std::streampos GetPosition(string name) const;
+#endif
+
+    string GetValue(string name) const;
+    string PeekValue(string name) const;
+
+    template <class T>
+    void GetValue(string name, T& value) const;
+    void GetValue(string name, int& value) const;
+    template <class T>
+    void PeekValue(string name, T& value) const;
+    template <class T>
+    void GetValue(string name, T min, T max, T& value) const;
+    template <class T>
+    void PeekValue(string name, T min, T max, T& value) const;
+    template <class T>
+    void GetValue(string name, string constraints, T& value) const;
+    template <class T>
+    void PeekValue(string name, string constraints, T& value) const;
+
+    void GetValue(string name, string& value) const;
+    void PeekValue(string name, string& value) const;
+    void GetValue(string name, string accepted, string& value,
+                  string delimiter) const;
+    void PeekValue(string name, string accepted, string& value,
+                   string delimiter) const;
+
+    void GetValue(string name, bool& value) const;
+    void PeekValue(string name, bool& value) const;
+
+  protected:
+    int FindField(const string& name) const;
   };
 
 }  // namespace Talos.
@@ -26,11 +26,191 @@
 #include "Date.hxx"
 #include "String.hxx"
 
+#include <clocale>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <locale>
+
+#if __cplusplus >= 201703L && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif
+#endif
+
 namespace Talos
 {
 
+
+  ///////////////////////
+  // NUMBER FORMATTING //
+  ///////////////////////
+
+
+  //! Writes an integer in a buffer, as the operator << with default flags.
+  /*!
+    \param[in] value the integer.
+    \param[out] buffer the integer, without null character. It should hold
+    at least 24 characters.
+    \return The number of characters written.
+  */
+  size_t format_integer(unsigned long long value, char* buffer)
+  {
+#ifdef __cpp_lib_to_chars
+    return std::to_chars(buffer, buffer + 24, value).ptr - buffer;
+#else
+    // Digits in reverse order.
+    char digit[24];
+    char* first = digit + sizeof(digit);
+    do
+      {
+        *--first = char('0' + value % 10);
+        value /= 10;
+      }
+    while (value != 0);
+    size_t length = digit + sizeof(digit) - first;
+    memcpy(buffer, first, length);
+    return length;
+#endif
+  }
+
+  //! Writes an integer in a buffer, as the operator << with default flags.
+  /*!
+    \param[in] value the integer.
+    \param[out] buffer the integer, without null character. It should hold
+    at least 24 characters.
+    \return The number of characters written.
+  */
+  size_t format_integer(long long value, char* buffer)
+  {
+#ifdef __cpp_lib_to_chars
+    return std::to_chars(buffer, buffer + 24, value).ptr - buffer;
+#else
+    unsigned long long magnitude = value < 0 ?
+      0ULL - (unsigned long long)(value) : (unsigned long long)(value);
+    size_t length = format_integer(magnitude, buffer + (value < 0));
+    if (value < 0)
+      {
+        buffer[0] = '-';
+        length++;
+      }
+    return length;
+#endif
+  }
+
+  //! Writes a floating-point number in a buffer, as with "%.*g".
+  /*!
+    The decimal point is always '.', as with a stream in the classic locale.
+    \param[in] value the number.
+    \param[in] precision the number of significant digits.
+    \param[out] buffer the number, without null character. It should hold
+    at least 32 characters.
+    \return The number of characters written.
+  */
+  size_t format_double(double value, int precision, char* buffer)
+  {
+#ifdef __cpp_lib_to_chars
+    return std::to_chars(buffer, buffer + 32, value,
+                         std::chars_format::general, precision).ptr - buffer;
+#else
+    int length = snprintf(buffer, 32, "%.*g", precision, value);
+    // The decimal point of the C locale is replaced.
+    const char* point = localeconv()->decimal_point;
+    if (point[0] != '.' || point[1] != '\0')
+      {
+        char* position = strstr(buffer, point);
+        if (position != NULL)
+          {
+            size_t point_length = strlen(point);
+            *position = '.';
+            memmove(position + 1, position + point_length,
+                    strlen(position + point_length) + 1);
+            length -= int(point_length) - 1;
+          }
+      }
+    return size_t(length);
+#endif
+  }
+
+  //! Writes the shortest representation of a floating-point number.
+  /*!
+    The number is written as with "%.*g", with the lowest precision such
+    that the number is read back exactly.
+    \param[in] value the number.
+    \param[out] buffer the number, without null character. It should hold
+    at least 32 characters.
+    \return The number of characters written.
+  */
+  size_t format_shortest(double value, char* buffer)
+  {
+    int precision = 17;
+#ifdef __cpp_lib_to_chars
+    // Number of significant digits of the shortest representation.
+    char* end = std::to_chars(buffer, buffer + 32, value,
+                              std::chars_format::scientific).ptr;
+    precision = 0;
+    for (char* p = buffer; p != end && *p != 'e'; ++p)
+      precision += *p >= '0' && *p <= '9';
+#else
+    // If a precision is enough, higher precisions are enough too.
+    int low = 1;
+    while (low < precision)
+      {
+        int middle = (low + precision) / 2;
+        size_t length = format_double(value, middle, buffer);
+        double read;
+        if (parse_num(buffer, buffer + length, read) == buffer + length
+            && read == value)
+          precision = middle;
+        else
+          low = middle + 1;
+      }
+#endif
+    return format_double(value, precision, buffer);
+  }
+
+  //! Writes characters padded to a given width in a string.
+  /*!
+    The characters are padded as by a stream: after them if the adjustment
+    is 'left', before them otherwise.
+    \param[in] input the characters.
+    \param[in] length the number of characters.
+    \param[in] l width of the output string.
+    \param[in] c char with which the string is filled.
+    \param[in] flags format flags.
+    \return The padded string.
+  */
+  string pad_string(const char* input, size_t length, int l, char c,
+                    ostringstream::fmtflags flags)
+  {
+    size_t width = l > 0 ? size_t(l) : 0;
+    if (width <= length)
+      return string(input, length);
+    string output;
+    output.reserve(width);
+    if ((flags & ostringstream::adjustfield) == ostringstream::left)
+      {
+        output.append(input, length);
+        output.append(width - length, c);
+      }
+    else
+      {
+        output.append(width - length, c);
+        output.append(input, length);
+      }
+    return output;
+  }
+
+
+  /////////
+  // STR //
+  /////////
+
+
   //! Default constructor.
-  Str::Str()
+  Str::Str():
+    data_(local_), size_(0), capacity_(sizeof(local_)), stream_(NULL)
   {
   }
 
@@ -38,15 +218,110 @@ namespace Talos
   /*!
     \param[in] s 'Str' instance to be copied.
   */
-  Str::Str(const Str& s)
+  Str::Str(const Str& s):
+    data_(local_), size_(0), capacity_(sizeof(local_)), stream_(NULL)
+  {
+    *this = s;
+  }
+
+  //! Move constructor.
+  /*!
+    The characters of 's' are taken over if they are heap-allocated.
+    \param[in] s 'Str' instance to be moved. It is left empty.
+  */
+  Str::Str(Str&& s):
+    data_(local_), size_(0), capacity_(sizeof(local_)), stream_(NULL)
+  {
+    *this = std::move(s);
+  }
+
+  //! Destructor.
+  Str::~Str()
+  {
+    if (data_ != local_)
+      delete[] data_;
+    delete stream_;
+  }
+
+  //! Assignment operator.
+  /*!
+    \param[in] s 'Str' instance to be copied.
+  */
+  Str& Str::operator=(const Str& s)
+  {
+    if (this == &s)
+      return *this;
+
+    size_ = 0;
+    Append(s.data_, s.size_);
+
+    delete stream_;
+    stream_ = NULL;
+    if (s.stream_ != NULL)
+      {
+        stream_ = new ostringstream;
+        stream_->copyfmt(*s.stream_);
+      }
+
+    return *this;
+  }
+
+  //! Move assignment operator.
+  /*!
+    The characters of 's' are taken over if they are heap-allocated.
+    \param[in] s 'Str' instance to be moved. It is left empty.
+  */
+  Str& Str::operator=(Str&& s)
   {
-    output_ << s;
+    if (this == &s)
+      return *this;
+
+    if (s.data_ == s.local_)
+      {
+        size_ = 0;
+        Append(s.data_, s.size_);
+      }
+    else
+      {
+        if (data_ != local_)
+          delete[] data_;
+        data_ = s.data_;
+        size_ = s.size_;
+        capacity_ = s.capacity_;
+        s.data_ = s.local_;
+        s.capacity_ = sizeof(s.local_);
+      }
+    s.size_ = 0;
+
+    delete stream_;
+    stream_ = s.stream_;
+    s.stream_ = NULL;
+
+    return *this;
   }
 
   //! Conversion to string.
   Str::operator std::string() const
   {
-    return output_.str();
+    return string(data_, size_);
+  }
+
+  //! Returns the characters.
+  /*!
+    \return A pointer to the characters, which are not null-terminated.
+  */
+  const char* Str::data() const
+  {
+    return data_;
+  }
+
+  //! Returns the number of characters.
+  /*!
+    \return The number of characters.
+  */
+  size_t Str::size() const
+  {
+    return size_;
   }
 
   //! Adds an element to the string.
@@ -56,10 +331,223 @@ namespace Talos
   template <class T>
   Str& Str::operator << (const T& input)
   {
-    output_ << input;
+    Write(input);
     return *this;
   }
 
+  //! Ensures that the buffer can hold a given number of characters.
+  /*!
+    The capacity is at least doubled, so that appending characters takes a
+    constant amortized time.
+    \param[in] size the number of characters.
+  */
+  void Str::Reserve(size_t size)
+  {
+    if (size <= capacity_)
+      return;
+    size_t capacity = max(size, 2 * capacity_);
+    char* data = new char[capacity];
+    memcpy(data, data_, size_);
+    if (data_ != local_)
+      delete[] data_;
+    data_ = data;
+    capacity_ = capacity;
+  }
+
+  //! Appends characters.
+  /*!
+    \param[in] str the characters.
+    \param[in] length the number of characters.
+  */
+  void Str::Append(const char* str, size_t length)
+  {
+    Reserve(size_ + length);
+    memcpy(data_ + size_, str, length);
+    size_ += length;
+  }
+
+  //! Discards the stream and its state.
+  /*!
+    The following elements are formatted with the default flags.
+  */
+  void Str::ResetStream()
+  {
+    delete stream_;
+    stream_ = NULL;
+  }
+
+  //! Appends a string.
+  /*!
+    \param[in] input the string.
+  */
+  void Str::Write(const string& input)
+  {
+    if (stream_ != NULL)
+      Write<string>(input);
+    else
+      Append(input.data(), input.size());
+  }
+
+  //! Appends a null-terminated string.
+  /*!
+    \param[in] input the string.
+  */
+  void Str::Write(const char* input)
+  {
+    if (stream_ != NULL)
+      Write<const char*>(input);
+    else
+      Append(input, strlen(input));
+  }
+
+  //! Appends the characters of another 'Str' instance.
+  /*!
+    \param[in] input the 'Str' instance.
+  */
+  void Str::Write(const Str& input)
+  {
+    if (stream_ != NULL)
+      Write<Str>(input);
+    else
+      Append(input.data_, input.size_);
+  }
+
+  //! Appends a character.
+  /*!
+    \param[in] input the character.
+  */
+  void Str::Write(char input)
+  {
+    if (stream_ != NULL)
+      Write<char>(input);
+    else
+      Append(&input, 1);
+  }
+
+  //! Appends a Boolean, as 0 or 1.
+  /*!
+    \param[in] input the Boolean.
+  */
+  void Str::Write(bool input)
+  {
+    if (stream_ != NULL)
+      Write<bool>(input);
+    else
+      Append(input ? "1" : "0", 1);
+  }
+
+  //! Appends an integer.
+  /*!
+    \param[in] input the integer.
+  */
+  void Str::Write(int input)
+  {
+    Write((long long)(input));
+  }
+
+  //! Appends an integer.
+  /*!
+    \param[in] input the integer.
+  */
+  void Str::Write(unsigned int input)
+  {
+    Write((unsigned long long)(input));
+  }
+
+  //! Appends an integer.
+  /*!
+    \param[in] input the integer.
+  */
+  void Str::Write(long input)
+  {
+    Write((long long)(input));
+  }
+
+  //! Appends an integer.
+  /*!
+    \param[in] input the integer.
+  */
+  void Str::Write(unsigned long input)
+  {
+    Write((unsigned long long)(input));
+  }
+
+  //! Appends an integer.
+  /*!
+    \param[in] input the integer.
+  */
+  void Str::Write(long long input)
+  {
+    if (stream_ != NULL)
+      Write<long long>(input);
+    else
+      {
+        char buffer[24];
+        Append(buffer, format_integer(input, buffer));
+      }
+  }
+
+  //! Appends an integer.
+  /*!
+    \param[in] input the integer.
+  */
+  void Str::Write(unsigned long long input)
+  {
+    if (stream_ != NULL)
+      Write<unsigned long long>(input);
+    else
+      {
+        char buffer[24];
+        Append(buffer, format_integer(input, buffer));
+      }
+  }
+
+  //! Appends a floating-point number.
+  /*!
+    The number is written with six significant digits, as with "%g".
+    \param[in] input the number.
+  */
+  void Str::Write(double input)
+  {
+    if (stream_ != NULL)
+      Write<double>(input);
+    else
+      {
+        char buffer[32];
+        Append(buffer, format_double(input, 6, buffer));
+      }
+  }
+
+  //! Appends a floating-point number.
+  /*!
+    The number is written with six significant digits, as with "%g".
+    \param[in] input the number.
+  */
+  void Str::Write(float input)
+  {
+    if (stream_ != NULL)
+      Write<float>(input);
+    else
+      Write(double(input));
+  }
+
+  //! Appends an element with its operator <<.
+  /*!
+    The element is written in a stream which is kept for the following
+    elements, so that stream manipulators apply to them.
+    \param[in] input the element.
+  */
+  template <class T>
+  void Str::Write(const T& input)
+  {
+    if (stream_ == NULL)
+      stream_ = new ostringstream;
+    *stream_ << input;
+    string output = stream_->str();
+    Append(output.data(), output.size());
+    stream_->str("");
+  }
+
   //! Adds an element to an instance of 'Str'.
   /*!
     \param[in] s 'Str' instance.
@@ -68,236 +556,1613 @@ namespace Talos
   template <class T>
   Str operator + (const Str& s, const T& input)
   {
-    string s_input = s;
-    Str output;
-    output << s_input << input;
+    Str output(s);
+    output.ResetStream();
+    output << input;
     return output;
   }
 
-  //! Converts a 'str' instance to an 'ostream' instance.
-  ostream& operator << (ostream& out, Str& in)
+  //! Adds an element to a temporary instance of 'Str'.
+  /*!
+    The characters of 's' are reused, so that a chain of additions takes a
+    time proportional to the length of the final string.
+    \param[in] s 'Str' instance.
+    \param[in] input element added at the end of the string.
+  */
+  template <class T>
+  Str operator + (Str&& s, const T& input)
   {
-    string output = in;
-    out << output;
-    return out;
+    s.ResetStream();
+    s << input;
+    return std::move(s);
   }
 
   //! Converts a 'str' instance to an 'ostream' instance.
-  ostream& operator << (ostream& out, Str in)
+  ostream& operator << (ostream& out, const Str& in)
   {
-    string output = in;
-    out << output;
+    if (out.width() != 0)
+      out << string(in);
+    else
+      out.write(in.data(), in.size());
     return out;
   }
 
-  //! Converts most types to string.
+  ////////////////
+  // STRINGVIEW //
+  ////////////////
+
+  //! Default constructor.
   /*!
-    \param input variable to be converted.
-    \return A string containing 'input'.
+    The view is empty.
+   */
+  StringView::StringView():
+    data_(""), size_(0)
+  {
+  }
+
+  //! Main constructor.
+  /*!
+    \param data first character.
+    \param size number of characters.
   */
-  template<typename T>
-  string to_str(const T& input)
+  StringView::StringView(const char* data, size_t size):
+    data_(data), size_(size)
   {
-    ostringstream output;
-    output << input;
-    return output.str();
   }
 
-  //! Fills a string.
+  //! Constructor from a C string.
   /*!
-    \param input string to be filled.
-    \param l (optional) width of the output string. Default: 2.
-    \param c (optional) char with which the string will be filled.
-    Default: ' '.
-    \param flags (optional) format flags. Default: ostringstream::right.
-    \return A string containing 'input' (filled).
+    \param str null-terminated string.
   */
-  string fill(const string& input, int l, char c,
-              ostringstream::fmtflags flags)
+  StringView::StringView(const char* str):
+    data_(str), size_(strlen(str))
   {
-    std::ostringstream output;
-    output.width(l);
-    output.fill(c);
-    output.flags(flags);
-    output << input;
-    return output.str();
   }
 
-  //! Converts most types to a filled string.
+  //! Constructor from a string.
   /*!
-    \param input variable to be converted.
-    \param l (optional) width of the output string. Default: 2.
-    \param c (optional) char with which the string will be filled.
-    Default: ' '.
-    \param flags (optional) format flags. Default: ostringstream::right.
-    \return A string containing 'input' (filled).
+    \param str the string, which should not be modified while the view is
+    in use.
   */
-  template<typename T>
-  string to_str_fill(const T& input, int l, char c,
-                     ostringstream::fmtflags flags)
+  StringView::StringView(const string& str):
+    data_(str.data()), size_(str.size())
   {
-    ostringstream output;
-    output.width(l);
-    output.fill(c);
-    output.flags(flags);
-    output << input;
+  }
+
+  //! Returns the first character.
+  /*!
+    \return A pointer to the first character.
+  */
+  const char* StringView::data() const
+  {
+    return data_;
+  }
+
+  //! Returns the number of characters.
+  /*!
+    \return The number of characters.
+  */
+  size_t StringView::size() const
+  {
+    return size_;
+  }
+
+  //! Checks whether the view is empty.
+  /*!
+    \return true if the view has no character, false otherwise.
+  */
+  bool StringView::empty() const
+  {
+    return size_ == 0;
+  }
+
+  //! Returns the beginning of the view.
+  /*!
+    \return A pointer to the first character.
+  */
+  const char* StringView::begin() const
+  {
+    return data_;
+  }
+
+  //! Returns the end of the view.
+  /*!
+    \return A pointer past the last character.
+  */
+  const char* StringView::end() const
+  {
+    return data_ + size_;
+  }
+
+  //! Access operator.
+  /*!
+    \param i index of the character.
+    \return The character at position \a i.
+  */
+  char StringView::operator[] (size_t i) const
+  {
+    return data_[i];
+  }
+
+  //! Returns a part of the view.
+  /*!
+    \param position index of the first character.
+    \param length (optional) maximum number of characters. Default: all
+    characters up to the end of the view.
+    \return The view on the characters [position, position + length[.
+  */
+  StringView StringView::substr(size_t position, size_t length) const
+  {
+    if (position > size_)
+      throw std::out_of_range("StringView::substr");
+    return StringView(data_ + position, min(length, size_ - position));
+  }
+
+  //! Converts to string.
+  /*!
+    \return A string with a copy of the characters.
+  */
+  string StringView::str() const
+  {
+    return string(data_, size_);
+  }
+
+  //! Comparison operator ==.
+  /*!
+    \param first view.
+    \param second view.
+    \return True if the views have the same characters.
+  */
+  bool operator == (const StringView& first, const StringView& second)
+  {
+    return first.size() == second.size()
+      && memcmp(first.data(), second.data(), first.size()) == 0;
+  }
+
+  //! Comparison operator !=.
+  /*!
+    \param first view.
+    \param second view.
+    \return True if the views have different characters.
+  */
+  bool operator != (const StringView& first, const StringView& second)
+  {
+    return !(first == second);
+  }
+
+  //! Redirection operator <<.
+  /*!
+    \param out output stream.
+    \param view the view to be displayed.
+    \return The updated stream.
+  */
+  ostream& operator << (ostream& out, const StringView& view)
+  {
+    return out.write(view.data(), view.size());
+  }
+
+
+  ///////////////
+  // SPLITVIEW //
+  ///////////////
+
+
+  //! Main constructor.
+  /*!
+    \param[in] str the string to be split. It must outlive the object.
+    \param[in] delimiters (optional) delimiters. Default: " \n\t".
+  */
+  SplitView::SplitView(const StringView& str, const StringView& delimiters):
+    str_(str), Ndelimiter_(delimiters.size()),
+    delimiter_(delimiters.empty() ? '\0' : delimiters[0])
+  {
+    if (Ndelimiter_ > 1)
+      {
+        memset(is_delimiter_, 0, sizeof(is_delimiter_));
+        for (size_t i = 0; i < Ndelimiter_; i++)
+          is_delimiter_[(unsigned char)(delimiters[i])] = true;
+      }
+  }
+
+  //! Returns an iterator to the first element.
+  /*!
+    \return An iterator to the first element.
+  */
+  SplitIterator SplitView::begin() const
+  {
+    return SplitIterator(*this, str_.begin());
+  }
+
+  //! Returns an iterator past the last element.
+  /*!
+    \return An iterator past the last element.
+  */
+  SplitIterator SplitView::end() const
+  {
+    return SplitIterator(*this, str_.end());
+  }
+
+  //! Is a character a delimiter?
+  /*!
+    \param[in] c the character.
+    \return True if 'c' is a delimiter, false otherwise.
+  */
+  inline bool SplitView::IsDelimiter(char c) const
+  {
+    if (Ndelimiter_ == 1)
+      return c == delimiter_;
+    return Ndelimiter_ != 0 && is_delimiter_[(unsigned char)(c)];
+  }
+
+  //! Skips delimiters.
+  /*!
+    \param[in] position a position in the string.
+    \return The position of the first character at or after 'position' that
+    is not a delimiter, or the end of the string.
+  */
+  const char* SplitView::SkipDelimiters(const char* position) const
+  {
+    const char* end = str_.end();
+    while (position != end && IsDelimiter(*position))
+      ++position;
+    return position;
+  }
+
+  //! Finds the next delimiter.
+  /*!
+    \param[in] position a position in the string.
+    \return The position of the first delimiter at or after 'position', or
+    the end of the string.
+  */
+  const char* SplitView::FindDelimiter(const char* position) const
+  {
+    const char* end = str_.end();
+    if (position == end)
+      return end;
+    if (Ndelimiter_ == 1)
+      {
+        const void* found = memchr(position, delimiter_, end - position);
+        return found == NULL ? end : static_cast<const char*>(found);
+      }
+    while (position != end && !IsDelimiter(*position))
+      ++position;
+    return position;
+  }
+
+  //! Default constructor.
+  SplitIterator::SplitIterator():
+    split_(NULL)
+  {
+  }
+
+  //! Main constructor.
+  /*!
+    \param[in] split the split string.
+    \param[in] position position from which the element is searched.
+  */
+  SplitIterator::SplitIterator(const SplitView& split, const char* position):
+    split_(&split)
+  {
+    const char* first = split.SkipDelimiters(position);
+    element_ = StringView(first, split.FindDelimiter(first) - first);
+  }
+
+  //! Returns the current element.
+  /*!
+    \return The current element.
+  */
+  const StringView& SplitIterator::operator* () const
+  {
+    return element_;
+  }
+
+  //! Returns a pointer to the current element.
+  /*!
+    \return A pointer to the current element.
+  */
+  const StringView* SplitIterator::operator-> () const
+  {
+    return &element_;
+  }
+
+  //! Moves to the next element.
+  /*!
+    \return The iterator, on the next element.
+  */
+  SplitIterator& SplitIterator::operator++ ()
+  {
+    *this = SplitIterator(*split_, element_.end());
+    return *this;
+  }
+
+  //! Moves to the next element.
+  /*!
+    \return A copy of the iterator before it was incremented.
+  */
+  SplitIterator SplitIterator::operator++ (int)
+  {
+    SplitIterator previous(*this);
+    ++*this;
+    return previous;
+  }
+
+  //! Checks whether two iterators point to the same element.
+  /*!
+    \param[in] iterator the other iterator, on the same string.
+    \return True if both iterators point to the same element, false
+    otherwise.
+  */
+  bool SplitIterator::operator == (const SplitIterator& iterator) const
+  {
+    return element_.data() == iterator.element_.data();
+  }
+
+  //! Checks whether two iterators point to different elements.
+  /*!
+    \param[in] iterator the other iterator, on the same string.
+    \return True if the iterators point to different elements, false
+    otherwise.
+  */
+  bool SplitIterator::operator != (const SplitIterator& iterator) const
+  {
+    return !(*this == iterator);
+  }
+
+  //! Formats an element without stream, if possible.
+  /*!
+    The overloads take the element, the format flags, a buffer of at least
+    32 characters (for numbers), and return the formatted characters (in the
+    buffer or in the element) and their number. They return true if the
+    element was formatted as by the operator << with the flags, false
+    otherwise. This generic version always fails, so that the element is
+    written with its operator <<.
+    \return False.
+  */
+  template <class T>
+  bool format_element(const T&, ostringstream::fmtflags, char*,
+                      const char*&, size_t&)
+  {
+    return false;
+  }
+
+  //! Formats a string.
+  /*!
+    The format flags and the buffer are not used.
+    \param[in] input the string.
+    \param[out] str the characters of 'input'.
+    \param[out] length the number of characters.
+    \return True.
+  */
+  bool format_element(const string& input, ostringstream::fmtflags, char*,
+                      const char*& str, size_t& length)
+  {
+    str = input.data();
+    length = input.size();
+    return true;
+  }
+
+  //! Formats a null-terminated string.
+  /*!
+    The format flags and the buffer are not used.
+    \param[in] input the string.
+    \param[out] str the characters of 'input'.
+    \param[out] length the number of characters.
+    \return True.
+  */
+  bool format_element(const char* input, ostringstream::fmtflags, char*,
+                      const char*& str, size_t& length)
+  {
+    str = input;
+    length = strlen(input);
+    return true;
+  }
+
+  //! Formats a character.
+  /*!
+    The format flags are not used.
+    \param[in] input the character.
+    \param[out] buffer the character.
+    \param[out] str 'buffer'.
+    \param[out] length one.
+    \return True.
+  */
+  bool format_element(char input, ostringstream::fmtflags, char* buffer,
+                      const char*& str, size_t& length)
+  {
+    buffer[0] = input;
+    str = buffer;
+    length = 1;
+    return true;
+  }
+
+  //! Formats an integer, unless it is in octal or hexadecimal notation.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  template <class T>
+  bool format_integer_element(T input, ostringstream::fmtflags flags,
+                              char* buffer, const char*& str, size_t& length)
+  {
+    ostringstream::fmtflags base = flags & ostringstream::basefield;
+    if (base == ostringstream::oct || base == ostringstream::hex
+        || (flags & ostringstream::showpos)
+        || (flags & ostringstream::adjustfield) == ostringstream::internal)
+      return false;
+    if (numeric_limits<T>::is_signed)
+      length = format_integer((long long)(input), buffer);
+    else
+      length = format_integer((unsigned long long)(input), buffer);
+    str = buffer;
+    return true;
+  }
+
+  //! Formats an integer.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(short input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_integer_element(input, flags, buffer, str, length);
+  }
+
+  //! Formats an integer.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(unsigned short input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_integer_element(input, flags, buffer, str, length);
+  }
+
+  //! Formats an integer.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(int input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_integer_element(input, flags, buffer, str, length);
+  }
+
+  //! Formats an integer.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(unsigned int input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_integer_element(input, flags, buffer, str, length);
+  }
+
+  //! Formats an integer.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(long input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_integer_element(input, flags, buffer, str, length);
+  }
+
+  //! Formats an integer.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(unsigned long input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_integer_element(input, flags, buffer, str, length);
+  }
+
+  //! Formats an integer.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(long long input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_integer_element(input, flags, buffer, str, length);
+  }
+
+  //! Formats an integer.
+  /*!
+    \param[in] input the integer.
+    \param[in] flags format flags.
+    \param[out] buffer the integer.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(unsigned long long input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_integer_element(input, flags, buffer, str, length);
+  }
+
+  //! Formats a floating-point number, in the default notation.
+  /*!
+    \param[in] input the number.
+    \param[in] flags format flags.
+    \param[out] buffer the number.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(double input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    if ((flags & (ostringstream::floatfield | ostringstream::showpoint
+                  | ostringstream::showpos | ostringstream::uppercase))
+        || (flags & ostringstream::adjustfield) == ostringstream::internal)
+      return false;
+    length = format_double(input, 6, buffer);
+    str = buffer;
+    return true;
+  }
+
+  //! Formats a floating-point number, in the default notation.
+  /*!
+    \param[in] input the number.
+    \param[in] flags format flags.
+    \param[out] buffer the number.
+    \param[out] str 'buffer'.
+    \param[out] length the number of characters.
+    \return True if 'input' was formatted, false if 'flags' require a
+    stream.
+  */
+  bool format_element(float input, ostringstream::fmtflags flags,
+                      char* buffer, const char*& str, size_t& length)
+  {
+    return format_element(double(input), flags, buffer, str, length);
+  }
+
+  //! Converts most types to string.
+  /*!
+    Strings, characters and numbers are converted without stream.
+    \param input variable to be converted.
+    \return A string containing 'input'.
+  */
+  template<typename T>
+  string to_str(const T& input)
+  {
+    char buffer[32];
+    const char* str;
+    size_t length;
+    if (format_element(input, ostringstream::dec, buffer, str, length))
+      return string(str, length);
+
+    ostringstream output;
+    output << input;
     return output.str();
   }
 
-  //! Converts string to most types, specially numbers.
+  //! Converts a floating-point number to its shortest representation.
+  /*!
+    The number is written as with "%.*g", with the lowest precision such
+    that the string is converted back to the same number. The decimal point
+    is always '.'.
+    \param input the number.
+    \return The shortest string representing 'input' exactly.
+  */
+  string to_str_shortest(double input)
+  {
+    char buffer[32];
+    return string(buffer, format_shortest(input, buffer));
+  }
+
+  //! Fills a string.
+  /*!
+    \param input string to be filled.
+    \param l (optional) width of the output string. Default: 2.
+    \param c (optional) char with which the string will be filled.
+    Default: ' '.
+    \param flags (optional) format flags. Default: ostringstream::right.
+    \return A string containing 'input' (filled).
+  */
+  string fill(const string& input, int l, char c,
+              ostringstream::fmtflags flags)
+  {
+    return pad_string(input.data(), input.size(), l, c, flags);
+  }
+
+  //! Fills characters, in a buffer.
+  /*!
+    The characters are padded as by 'fill'. As with 'snprintf', at most
+    'size' - 1 characters are written, followed by a null character.
+    \param input characters to be filled.
+    \param length number of characters in 'input'.
+    \param buffer (output) the filled characters.
+    \param size size of 'buffer'.
+    \param l (optional) width of the output string. Default: 2.
+    \param c (optional) char with which the string will be filled.
+    Default: ' '.
+    \param flags (optional) format flags. Default: ostringstream::left.
+    \return The length of the filled characters, which may be greater than
+    the number of characters written.
+  */
+  size_t fill(const char* input, size_t length, char* buffer, size_t size,
+              int l, char c, ostringstream::fmtflags flags)
+  {
+    size_t width = l > 0 ? max(size_t(l), length) : length;
+    if (size == 0)
+      return width;
+
+    // Padding before the characters, characters and padding after them.
+    size_t before = (flags & ostringstream::adjustfield)
+      == ostringstream::left ? 0 : width - length;
+    size_t last = size - 1;
+    memset(buffer, c, min(before, last));
+    if (before < last)
+      memcpy(buffer + before, input, min(length, last - before));
+    if (before + length < last)
+      memset(buffer + before + length, c,
+             min(width - before - length, last - before - length));
+    buffer[min(width, last)] = '\0';
+    return width;
+  }
+
+  //! Converts most types to a filled string.
+  /*!
+    Strings, characters and numbers are converted without stream, unless
+    'flags' require octal, hexadecimal or fixed notations for instance.
+    \param input variable to be converted.
+    \param l (optional) width of the output string. Default: 2.
+    \param c (optional) char with which the string will be filled.
+    Default: ' '.
+    \param flags (optional) format flags. Default: ostringstream::right.
+    \return A string containing 'input' (filled).
+  */
+  template<typename T>
+  string to_str_fill(const T& input, int l, char c,
+                     ostringstream::fmtflags flags)
+  {
+    char buffer[32];
+    const char* str;
+    size_t length;
+    if (format_element(input, flags, buffer, str, length))
+      return pad_string(str, length, l, c, flags);
+
+    ostringstream output;
+    output.width(l);
+    output.fill(c);
+    output.flags(flags);
+    output << input;
+    return output.str();
+  }
+
+  //! Powers of ten that are exactly represented in double precision.
+  static const double parse_num_power_[] =
+    {1.e0, 1.e1, 1.e2, 1.e3, 1.e4, 1.e5, 1.e6, 1.e7, 1.e8, 1.e9, 1.e10,
+     1.e11, 1.e12, 1.e13, 1.e14, 1.e15, 1.e16, 1.e17, 1.e18, 1.e19, 1.e20,
+     1.e21, 1.e22};
+
+  //! Converts a decimal number to a floating-point number, if exact.
+  /*!
+    The overloads take the sign, the decimal digits and the power of ten of
+    the number, and return true if the number could be computed exactly.
+    The generic version never succeeds, so that the caller falls back to a
+    general conversion.
+    \return False.
+  */
+  template <class T>
+  bool parse_num_exact(bool, unsigned long long, int, T&)
+  {
+    return false;
+  }
+
+  //! Converts a decimal number to a double, if exact.
+  /*!
+    If the mantissa and the power of ten are both exactly represented, a
+    single multiplication or division yields the correctly rounded result.
+    \param negative is the number negative?
+    \param mantissa the decimal digits of the number.
+    \param exponent the power of ten applied to 'mantissa'.
+    \param num (output) the number.
+    \return True if 'num' could be computed exactly, false otherwise.
+  */
+  bool parse_num_exact(bool negative, unsigned long long mantissa,
+                       int exponent, double& num)
+  {
+    if (mantissa > (1ULL << 53) || exponent < -22 || exponent > 22)
+      return false;
+    num = double(mantissa);
+    if (exponent < 0)
+      num /= parse_num_power_[-exponent];
+    else
+      num *= parse_num_power_[exponent];
+    if (negative)
+      num = -num;
+    return true;
+  }
+
+  //! Converts a decimal number to a float, if exact.
+  /*!
+    \param negative is the number negative?
+    \param mantissa the decimal digits of the number.
+    \param exponent the power of ten applied to 'mantissa'.
+    \param num (output) the number.
+    \return True if 'num' could be computed exactly, false otherwise.
+  */
+  bool parse_num_exact(bool negative, unsigned long long mantissa,
+                       int exponent, float& num)
+  {
+    if (mantissa > (1ULL << 24) || exponent < -10 || exponent > 10)
+      return false;
+    num = float(mantissa);
+    if (exponent < 0)
+      num /= float(parse_num_power_[-exponent]);
+    else
+      num *= float(parse_num_power_[exponent]);
+    if (negative)
+      num = -num;
+    return true;
+  }
+
+  //! Converts a number with the general (slow) method.
+  /*!
+    The conversion does not depend on the global locale.
+    \param begin beginning of the number.
+    \param end end of the number.
+    \param num (output) the number.
+  */
+  template <class T>
+  void parse_num_general(const char* begin, const char* end, T& num)
+  {
+#ifdef __cpp_lib_to_chars
+    if (std::from_chars(*begin == '+' ? begin + 1 : begin, end, num).ec
+        == std::errc())
+      return;
+#endif
+    istringstream str(string(begin, end));
+    str.imbue(std::locale::classic());
+    str >> num;
+  }
+
+  //! Converts the integral part of a number to an integer.
+  /*!
+    The conversion follows 'to_num': an overflow yields the largest (or
+    lowest) value of 'T'.
+    \param negative is the number negative?
+    \param begin beginning of the digits.
+    \param end end of the digits.
+    \param num (output) the number.
+    \return False in case of overflow, true otherwise.
+  */
+  template <class T>
+  bool parse_num_integer(bool negative, const char* begin, const char* end,
+                         T& num)
+  {
+    // Floating-point types are never converted here, but the function is
+    // instantiated for them.
+    const unsigned long long max = numeric_limits<T>::is_integer ?
+      (unsigned long long)(numeric_limits<T>::max()) : 0ULL;
+    const unsigned long long limit
+      = negative && numeric_limits<T>::is_signed ? max + 1 : max;
+
+    unsigned long long value = 0;
+    for (; begin != end; ++begin)
+      {
+        unsigned long long digit = *begin - '0';
+        if (value > (limit - digit) / 10)
+          {
+            num = negative && numeric_limits<T>::is_signed ?
+              numeric_limits<T>::min() : numeric_limits<T>::max();
+            return false;
+          }
+        value = 10 * value + digit;
+      }
+
+    if (!negative || value == 0)
+      num = T(value);
+    else if (numeric_limits<T>::is_signed)
+      num = T(-T(value - 1) - T(1));
+    else
+      num = T(T(0) - T(value));
+    return true;
+  }
+
+  //! Parses a number at the beginning of a sequence of characters.
+  /*!
+    The number is written in the format accepted by 'is_num', and the
+    conversion does not depend on the locale. Floating-point numbers are
+    correctly rounded. Integral types are converted as in 'to_num', that is,
+    only from the digits preceding the decimal point and the exponent.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number. It is left unchanged if no number could
+    be parsed.
+    \return A pointer to the first character after the number, or 'begin' if
+    no number could be parsed.
+  */
+  template <class T>
+  const char* parse_num(const char* begin, const char* end, T& num)
+  {
+    const char* p = begin;
+    bool negative = false;
+    if (p != end && (*p == '+' || *p == '-'))
+      negative = *p++ == '-';
+
+    // Decimal digits (at most 19, which fit in 64 bits) and power of ten.
+    unsigned long long mantissa = 0;
+    int Ndigit = 0;
+    int exponent = 0;
+    // Are non-zero digits missing from 'mantissa'?
+    bool truncated = false;
+
+    // Mantissa in the form: [integral].[fractional].
+    const char* integral = p;
+    for (; p != end && *p >= '0' && *p <= '9'; ++p)
+      if (Ndigit < 19)
+        {
+          mantissa = 10 * mantissa + (*p - '0');
+          Ndigit += mantissa != 0;
+        }
+      else
+        {
+          exponent++;
+          truncated = truncated || *p != '0';
+        }
+    const char* integral_end = p;
+
+    bool fractional = false;
+    if (p != end && *p == '.')
+      for (++p; p != end && *p >= '0' && *p <= '9'; ++p)
+        {
+          fractional = true;
+          if (Ndigit < 19)
+            {
+              mantissa = 10 * mantissa + (*p - '0');
+              Ndigit += mantissa != 0;
+              exponent--;
+            }
+          else
+            truncated = truncated || *p != '0';
+        }
+
+    if (integral == integral_end && !fractional)
+      return begin;
+
+    // Exponent, only if it has digits.
+    if (p != end && (*p == 'e' || *p == 'E'))
+      {
+        const char* q = p + 1;
+        bool negative_exponent = false;
+        if (q != end && (*q == '+' || *q == '-'))
+          negative_exponent = *q++ == '-';
+        if (q != end && *q >= '0' && *q <= '9')
+          {
+            int value = 0;
+            for (; q != end && *q >= '0' && *q <= '9'; ++q)
+              if (value < 100000)
+                value = 10 * value + (*q - '0');
+            exponent += negative_exponent ? -value : value;
+            p = q;
+          }
+      }
+
+    if (numeric_limits<T>::is_integer)
+      parse_num_integer(negative, integral, integral_end, num);
+    else if (truncated
+             || !parse_num_exact(negative, mantissa, exponent, num))
+      parse_num_general(begin, p, num);
+
+    return p;
+  }
+
+  //! Is a character a white space, in the classic locale?
+  /*!
+    \param c the character.
+    \return True if 'c' is a white space, false otherwise.
+  */
+  inline bool is_classic_space(char c)
+  {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+  }
+
+  //! Converts a sequence of characters with the operator >>.
+  /*!
+    This generic version is used for the types that are not numbers.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the characters converted to 'T'.
+    \return True if all characters were read, except trailing white spaces,
+    false otherwise.
+  */
+  template <class T>
+  bool convert_num(const char* begin, const char* end, T& num)
+  {
+    istringstream str(string(begin, end));
+    str >> num;
+    return !str.fail() && (str >> std::ws).eof();
+  }
+
+  //! Converts a sequence of characters to a number, without stream.
+  /*!
+    The result is the one of the operator >> of an 'istringstream' in the
+    classic locale: leading white spaces are skipped, the conversion stops
+    at the first character that cannot be part of the number, an overflow
+    yields the largest (or lowest) value of 'T', and 'num' is set to zero if
+    no number could be read. 'num' is left unchanged if there are only white
+    spaces.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters (but leading and trailing white spaces)
+    are exactly a number in the range of 'T', false otherwise.
+  */
+  template <class T>
+  bool convert_arithmetic(const char* begin, const char* end, T& num)
+  {
+    while (begin != end && is_classic_space(*begin))
+      ++begin;
+    if (begin == end)
+      return false;
+
+    const char* p = begin;
+    bool valid = true;
+    if (numeric_limits<T>::is_integer)
+      {
+        bool negative = false;
+        if (*p == '+' || *p == '-')
+          negative = *p++ == '-';
+        const char* digits = p;
+        while (p != end && *p >= '0' && *p <= '9')
+          ++p;
+        if (p == digits)
+          {
+            num = T(0);
+            return false;
+          }
+        valid = parse_num_integer(negative, digits, p, num);
+      }
+    else
+      {
+        p = parse_num(begin, end, num);
+        // A first exponent without digits fails the stream conversion.
+        bool failed = p == begin;
+        if (!failed && p != end && (*p == 'e' || *p == 'E'))
+          {
+            failed = true;
+            for (const char* q = begin; q != p; ++q)
+              failed = failed && *q != 'e' && *q != 'E';
+          }
+        if (failed)
+          {
+            num = T(0);
+            return false;
+          }
+        // An overflow yields the largest value, as with a stream.
+        if (num == numeric_limits<T>::max()
+            || num == -numeric_limits<T>::max())
+          {
+            istringstream str(string(begin, p));
+            str.imbue(std::locale::classic());
+            T tmp;
+            valid = bool(str >> tmp);
+          }
+      }
+
+    while (p != end && is_classic_space(*p))
+      ++p;
+    return valid && p == end;
+  }
+
+  //! Converts a sequence of characters to a short integer.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, short& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to an unsigned short integer.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, unsigned short& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to an integer.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, int& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to an unsigned integer.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, unsigned int& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to a long integer.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, long& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to an unsigned long integer.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, unsigned long& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to a long long integer.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, long long& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to an unsigned long long integer.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, unsigned long long& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to a float.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, float& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to a double.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, double& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to a long double.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number.
+    \return True if the characters are exactly a number, false otherwise.
+  */
+  bool convert_num(const char* begin, const char* end, long double& num)
+  {
+    return convert_arithmetic(begin, end, num);
+  }
+
+  //! Converts a sequence of characters to most types, specially numbers.
+  /*!
+    Numbers (but characters and Booleans) are converted without stream and
+    independently of the locale, with the same result as the operator >>.
+    Other types are read with their operator >>.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the characters converted to 'T'.
+    \return True if the characters, except leading and trailing white
+    spaces, were entirely converted (and, for a number, if it is in the
+    range of 'T'), false otherwise.
+  */
+  template <class T>
+  bool to_num(const char* begin, const char* end, T& num)
+  {
+    return convert_num(begin, end, num);
+  }
+
+  //! Converts string to most types, specially numbers.
+  /*!
+    \param s string to be converted.
+    \param num 's' converted to 'T'.
+    \param strict (optional) if true, an exception is thrown if 's' is not
+    entirely converted (except leading and trailing white spaces), or if a
+    number is out of the range of 'T'. Otherwise, the conversion silently
+    stops at the first invalid character. Default: false.
+  */
+  template <class T>
+  void to_num(const string& s, T& num, bool strict)
+  {
+    if (!convert_num(s.data(), s.data() + s.size(), num) && strict)
+      throw string("Unable to convert \"") + s
+        + string("\": it is not a valid value or it is out of range.");
+  }
+
+  //! Converts string to most types, specially numbers.
+  /*!
+    \param s string to be converted.
+    \param strict (optional) if true, an exception is thrown if 's' is not
+    entirely converted (except leading and trailing white spaces), or if a
+    number is out of the range of 'T'. Default: false.
+    \return 's' converted to 'T'.
+  */
+  template <class T>
+  T to_num(const string& s, bool strict)
+  {
+    T num;
+    to_num(s, num, strict);
+    return num;
+  }
+
+  //! Converts strings to most types.
+  /*!
+    \param s string to be converted.
+    \param out 's' converted to 'T'.
+  */
+  template <class T>
+  void convert(const string& s, T& out)
+  {
+    convert_num(s.data(), s.data() + s.size(), out);
+  }
+
+  //! Sets a string.
+  /*!
+    \param s input string.
+    \param out output string, equal to 's' on exit.
+  */
+  void convert(const string& s, string& out)
+  {
+    out = s;
+  }
+
+  //! Converts a string to a boolean.
+  /*!
+    \param s input string.
+    \param out output boolean.
+  */
+  void convert(const string& s, bool& out)
+  {
+    std::string lower(s);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   (int(*)(int))tolower);
+
+    if (lower == "true" || lower == "t" || lower == "y" || lower == "yes")
+      out = true;
+    else if (lower == "false" || lower == "f" || lower == "n"
+             || lower == "no")
+      out = false;
+    else
+#ifdef TALOS_DO_NOT_CHECK_BOOLEAN
+      {
+        istringstream str(s);
+        str >> out;
+      }
+#else
+    throw string("Unable to convert \"") + s
+      + string("\" to a Boolean. Acceptable strings (case insensitive)")
+      + string(" are: true, t, yes, y, false, f, no, n.");
+#endif
+  }
+
+  //! Converts strings to most types.
+  /*!
+    \param s input string to be converted.
+    \return 's' converted to 'T'.
+  */
+  template <class T>
+  T convert(const string& s)
+  {
+    T out;
+    convert_num(s.data(), s.data() + s.size(), out);
+    return out;
+  }
+
+  //! Converts a string to lower-case string.
+  /*!
+    \param str string to be converted.
+    \return 'str' in lower case.
+  */
+  string lower_case(string str)
+  {
+    string lower(str);
+    std::transform(lower.begin(), lower.end(), lower.begin(),
+                   (int(*)(int))tolower);
+    return lower;
+  }
+
+  //! Converts a string to upper-case string.
+  /*!
+    \param str string to be converted.
+    \return 'str' in upper case.
+  */
+  string upper_case(string str)
+  {
+    string upper(str);
+    std::transform(upper.begin(), upper.end(), upper.begin(),
+                   (int(*)(int))toupper);
+    return upper;
+  }
+
+  //! Skips decimal digits.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \return A pointer to the first character that is not a digit, or 'end'.
+  */
+  inline const char* skip_digits(const char* begin, const char* end)
+  {
+    while (begin != end && *begin >= '0' && *begin <= '9')
+      ++begin;
+    return begin;
+  }
+
+  //! Checks whether a sequence of characters is a number.
+  /*!
+    A number is made of an optional sign, a mantissa with at least one
+    digit and an optional decimal point, and an optional exponent ('e' or
+    'E' followed by an integer). The characters are checked in a single
+    pass, without memory allocation.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \return true if the characters are a number, false otherwise.
+  */
+  bool is_num(const char* begin, const char* end)
+  {
+    const char* p = begin;
+    if (p != end && (*p == '+' || *p == '-'))
+      ++p;
+
+    // Mantissa in the form: [integral].[fractional].
+    const char* integral = p;
+    p = skip_digits(p, end);
+    bool digit = p != integral;
+    if (p != end && *p == '.')
+      {
+        const char* fractional = ++p;
+        p = skip_digits(p, end);
+        digit = digit || p != fractional;
+      }
+    if (!digit)
+      return false;
+
+    if (p != end && (*p == 'e' || *p == 'E'))
+      return is_integer(p + 1, end);
+    return p == end;
+  }
+
+  //! Checks whether a string is a number.
+  /*!
+    \param str string to be checked.
+    \return true if 'str' is a number, false otherwise.
+  */
+  bool is_num(const string& str)
+  {
+    return is_num(str.data(), str.data() + str.size());
+  }
+
+  //! Checks whether characters are a number and converts them.
+  /*!
+    The characters are checked by 'is_num' and converted as by 'to_num'.
+    This generic version is used for the types that are not numbers.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
+  */
+  template <class T>
+  bool parse_valid_num(const char* begin, const char* end, T& num)
+  {
+    if (!is_num(begin, end))
+      return false;
+    convert_num(begin, end, num);
+    return true;
+  }
+
+  //! Checks whether characters are a number and converts them in one pass.
+  /*!
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
+  */
+  template <class T>
+  bool parse_whole_num(const char* begin, const char* end, T& num)
+  {
+    T value;
+    if (begin == end || parse_num(begin, end, value) != end)
+      return false;
+    num = value;
+    return true;
+  }
+
+  //! Checks whether characters are a number, and converts them.
+  /*!
+    The number is a short integer.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
+  */
+  bool parse_valid_num(const char* begin, const char* end, short& num)
+  {
+    return parse_whole_num(begin, end, num);
+  }
+
+  //! Checks whether characters are a number, and converts them.
+  /*!
+    The number is an unsigned short integer.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
+  */
+  bool parse_valid_num(const char* begin, const char* end, unsigned short& num)
+  {
+    return parse_whole_num(begin, end, num);
+  }
+
+  //! Checks whether characters are a number, and converts them.
+  /*!
+    The number is an integer.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
+  */
+  bool parse_valid_num(const char* begin, const char* end, int& num)
+  {
+    return parse_whole_num(begin, end, num);
+  }
+
+  //! Checks whether characters are a number, and converts them.
   /*!
-    \param s string to be converted.
-    \param num 's' converted to 'T'.
+    The number is an unsigned integer.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
   */
-  template <class T>
-  void to_num(const string& s, T& num)
+  bool parse_valid_num(const char* begin, const char* end, unsigned int& num)
   {
-    istringstream str(s);
-    str >> num;
+    return parse_whole_num(begin, end, num);
   }
 
-  //! Converts string to most types, specially numbers.
+  //! Checks whether characters are a number, and converts them.
   /*!
-    \param s string to be converted.
-    \return 's' converted to 'T'.
+    The number is a long integer.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
   */
-  template <class T>
-  T to_num(const string& s)
+  bool parse_valid_num(const char* begin, const char* end, long& num)
   {
-    T num;
-    istringstream str(s);
-    str >> num;
-    return num;
+    return parse_whole_num(begin, end, num);
   }
 
-  //! Converts strings to most types.
+  //! Checks whether characters are a number, and converts them.
   /*!
-    \param s string to be converted.
-    \param out 's' converted to 'T'.
+    The number is an unsigned long integer.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
   */
-  template <class T>
-  void convert(const string& s, T& out)
+  bool parse_valid_num(const char* begin, const char* end, unsigned long& num)
   {
-    istringstream str(s);
-    str >> out;
+    return parse_whole_num(begin, end, num);
   }
 
-  //! Sets a string.
+  //! Checks whether characters are a number, and converts them.
   /*!
-    \param s input string.
-    \param out output string, equal to 's' on exit.
+    The number is a long long integer.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
   */
-  void convert(const string& s, string& out)
+  bool parse_valid_num(const char* begin, const char* end, long long& num)
   {
-    out = s;
+    return parse_whole_num(begin, end, num);
   }
 
-  //! Converts a string to a boolean.
+  //! Checks whether characters are a number, and converts them.
   /*!
-    \param s input string.
-    \param out output boolean.
+    The number is an unsigned long long integer.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
   */
-  void convert(const string& s, bool& out)
+  bool parse_valid_num(const char* begin, const char* end,
+                       unsigned long long& num)
   {
-    std::string lower(s);
-    std::transform(lower.begin(), lower.end(), lower.begin(),
-                   (int(*)(int))tolower);
+    return parse_whole_num(begin, end, num);
+  }
 
-    if (lower == "true" || lower == "t" || lower == "y" || lower == "yes")
-      out = true;
-    else if (lower == "false" || lower == "f" || lower == "n"
-             || lower == "no")
-      out = false;
-    else
-#ifdef TALOS_DO_NOT_CHECK_BOOLEAN
-      {
-        istringstream str(s);
-        str >> out;
-      }
-#else
-    throw string("Unable to convert \"") + s
-      + string("\" to a Boolean. Acceptable strings (case insensitive)")
-      + string(" are: true, t, yes, y, false, f, no, n.");
-#endif
+  //! Checks whether characters are a number, and converts them.
+  /*!
+    The number is a float.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
+  */
+  bool parse_valid_num(const char* begin, const char* end, float& num)
+  {
+    return parse_whole_num(begin, end, num);
   }
 
-  //! Converts strings to most types.
+  //! Checks whether characters are a number, and converts them.
   /*!
-    \param s input string to be converted.
-    \return 's' converted to 'T'.
+    The number is a double.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
   */
-  template <class T>
-  T convert(const string& s)
+  bool parse_valid_num(const char* begin, const char* end, double& num)
   {
-    T out;
-    istringstream str(s);
-    str >> out;
-    return out;
+    return parse_whole_num(begin, end, num);
   }
 
-  //! Converts a string to lower-case string.
+  //! Checks whether characters are a number, and converts them.
   /*!
-    \param str string to be converted.
-    \return 'str' in lower case.
+    The number is a long double.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number, unchanged if the characters are not a
+    number.
+    \return true if the characters are a number, false otherwise.
   */
-  string lower_case(string str)
+  bool parse_valid_num(const char* begin, const char* end, long double& num)
   {
-    string lower(str);
-    std::transform(lower.begin(), lower.end(), lower.begin(),
-                   (int(*)(int))tolower);
-    return lower;
+    return parse_whole_num(begin, end, num);
   }
 
-  //! Converts a string to upper-case string.
+  //! Checks whether a sequence of characters is a number and converts it.
   /*!
-    \param str string to be converted.
-    \return 'str' in upper case.
+    The characters are checked as by 'is_num', and converted as by 'to_num'.
+    For numbers, both are done in a single pass.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \param num (output) the number. It is left unchanged if the characters
+    are not a number.
+    \return true if the characters are a number, false otherwise.
   */
-  string upper_case(string str)
+  template <class T>
+  bool is_num(const char* begin, const char* end, T& num)
   {
-    string upper(str);
-    std::transform(upper.begin(), upper.end(), upper.begin(),
-                   (int(*)(int))toupper);
-    return upper;
+    return parse_valid_num(begin, end, num);
   }
 
-  //! Checks whether a string is a number.
+  //! Checks whether a string is a number and converts it.
   /*!
+    The string is checked as by 'is_num', and converted as by 'to_num'.
+    For numbers, both are done in a single pass.
     \param str string to be checked.
+    \param num (output) the number. It is left unchanged if 'str' is not a
+    number.
     \return true if 'str' is a number, false otherwise.
   */
-  bool is_num(const string& str)
+  template <class T>
+  bool is_num(const string& str, T& num)
   {
-    if (str == "")
-      return false;
-
-    bool mant, mant_a, mant_b, exp;
-    string::size_type pos;
-    string m, e, m_a, m_b;
-
-    pos = str.find_first_of("eE");
-    // Mantissa.
-    m = str.substr(0, pos);
-    // Exponent.
-    e = pos == string::npos ? "" : str.substr(pos + 1);
-
-    exp = pos != string::npos;
-
-    pos = m.find_first_of(".");
-    // Mantissa in the form: [m_a].[m_b].
-    m_a = m.substr(0, pos);
-    // Exponent.
-    m_b = pos == string::npos ? "" : m.substr(pos + 1);
-
-    mant = m != "" && m != "-" && m != "+";
-    mant_a = m_a != "" && m_a != "-" && m_a != "+";
-    mant_b = m_b != "";
+    return parse_valid_num(str.data(), str.data() + str.size(), num);
+  }
 
-    return (mant
-            && ((mant_a || mant_b)
-                && (!mant_a || is_integer(m_a))
-                && (!mant_b || is_unsigned_integer(m_b)))
-            && (!exp || is_integer(e)));
+  //! Checks whether a sequence of characters is an integer.
+  /*!
+    An integer is made of an optional sign followed by digits.
+    \param begin beginning of the characters.
+    \param end end of the characters.
+    \return true if the characters are an integer, false otherwise.
+  */
+  bool is_integer(const char* begin, const char* end)
+  {
+    if (begin != end && (*begin == '+' || *begin == '-'))
+      ++begin;
+    return begin != end && skip_digits(begin, end) == end;
   }
 
   //! Checks whether a string is an integer.
@@ -307,7 +2172,7 @@ namespace Talos
   */
   bool is_integer(char* str)
   {
-    return is_integer(string(str));
+    return is_integer(str, str + strlen(str));
   }
 
   //! Checks whether a string is an integer.
@@ -317,7 +2182,7 @@ namespace Talos
   */
   bool is_integer(const char* str)
   {
-    return is_integer(string(str));
+    return is_integer(str, str + strlen(str));
   }
 
   //! Checks whether a string is an integer.
@@ -327,19 +2192,7 @@ namespace Talos
   */
   bool is_integer(const string& str)
   {
-    bool ans;
-
-    ans = (str.size() > 0 && isdigit(str[0]))
-      || (str.size() > 1 && (str[0] == '+' || str[0] == '-'));
-
-    unsigned int i(1);
-    while (i < str.size() && ans)
-      {
-        ans = ans && isdigit(str[i]);
-        i++;
-      }
-
-    return ans;
+    return is_integer(str.data(), str.data() + str.size());
   }
 
   //! Checks whether a string is an unsigned integer.
@@ -349,16 +2202,8 @@ namespace Talos
   */
   bool is_unsigned_integer(const string& str)
   {
-    bool ans(str.size() > 0);
-
-    unsigned int i(0);
-    while (i < str.size() && ans)
-      {
-        ans = ans && isdigit(str[i]);
-        i++;
-      }
-
-    return ans;
+    const char* end = str.data() + str.size();
+    return !str.empty() && skip_digits(str.data(), end) == end;
   }
 
   //! Checks whether a string is a date.
@@ -368,20 +2213,10 @@ namespace Talos
   */
   bool is_date(const string& str)
   {
-    bool ans = true;
-
-
     if (!isdigit(str[0]))
       return false;
-    try
-      {
-        Date d(str);
-      }
-    catch (...)
-      {
-        ans = false;
-      }
-    return ans;
+    long long seconds;
+    return parse_date(str.data(), str.data() + str.size(), seconds);
   }
 
   //! Checks whether a string is a valid time interval.
@@ -397,15 +2232,28 @@ namespace Talos
          str.find('d', 0) >= str.find('h', 0)))
       return false;
 
-    vector<string> period = split(str, "dh-_");
-
-    if (period.size() > 2 || period.size() == 0)
-      return false;
-
-    if (period.size() == 2)
-      return (is_integer(period[0]) && is_integer(period[1]));
-    else
-      return is_integer(period[0]);
+    // One or two integers are expected, delimited with 'd', 'h', '-' or
+    // '_'.
+    int nb_integer = 0;
+    string::size_type i = 0;
+    while (i < str.size())
+      if (str[i] == 'd' || str[i] == 'h' || str[i] == '-' || str[i] == '_')
+        i++;
+      else
+        {
+          if (++nb_integer > 2)
+            return false;
+          if (str[i] == '+')
+            i++;
+          if (i == str.size() || !isdigit(str[i]))
+            return false;
+          for (; i < str.size() && str[i] != 'd' && str[i] != 'h'
+                 && str[i] != '-' && str[i] != '_'; i++)
+            if (!isdigit(str[i]))
+              return false;
+        }
+
+    return nb_integer != 0;
   }
 
   //! Finds and replace a substring.
@@ -480,32 +2328,126 @@ namespace Talos
     return str.substr(0, index + 1);
   }
 
+  //! Converts an element of a split string to most types.
+  /*!
+    \param view the element.
+    \param out 'view' converted to 'T'.
+  */
+  template <class T>
+  void convert_view(const StringView& view, T& out)
+  {
+    convert_num(view.begin(), view.end(), out);
+  }
+
+  //! Sets a string to an element of a split string.
+  /*!
+    \param view the element.
+    \param out (output) the characters of 'view'. Its memory is reused.
+  */
+  void convert_view(const StringView& view, string& out)
+  {
+    out.assign(view.data(), view.size());
+  }
+
+  //! Converts an element of a split string to a Boolean.
+  /*!
+    \param view the element.
+    \param out (output) the Boolean, as converted by 'convert'.
+  */
+  void convert_view(const StringView& view, bool& out)
+  {
+    convert(view.str(), out);
+  }
+
+  //! Sets a view to an element of a split string.
+  /*!
+    \param view the element.
+    \param out (output) 'view'.
+  */
+  void convert_view(const StringView& view, StringView& out)
+  {
+    out = view;
+  }
+
+  //! Checks whether characters lie in a given memory block.
+  /*!
+    \param view the characters.
+    \param begin beginning of the block.
+    \param size size of the block, in bytes.
+    \return true if 'view' and the block overlap, false otherwise.
+  */
+  bool overlaps(const StringView& view, const void* begin, size_t size)
+  {
+    std::less<const char*> less;
+    const char* first = static_cast<const char*>(begin);
+    return less(view.begin(), first + size) && less(first, view.end());
+  }
+
+  //! Checks whether characters lie in the storage of a vector.
+  /*!
+    \param view the characters.
+    \param vect the vector.
+    \return true if 'view' points into the elements of 'vect', false
+    otherwise.
+  */
+  template <class T>
+  bool overlaps(const StringView& view, const vector<T>& vect)
+  {
+    return overlaps(view, vect.data(), vect.capacity() * sizeof(T));
+  }
+
+  //! Checks whether characters lie in the storage of a vector of strings.
+  /*!
+    \param view the characters.
+    \param vect the vector.
+    \return true if 'view' points into the elements of 'vect' or into the
+    characters of one of them, false otherwise.
+  */
+  bool overlaps(const StringView& view, const vector<string>& vect)
+  {
+    if (overlaps(view, vect.data(), vect.capacity() * sizeof(string)))
+      return true;
+    for (size_t i = 0; i < vect.size(); i++)
+      if (overlaps(view, vect[i].data(), vect[i].capacity()))
+        return true;
+    return false;
+  }
+
   //! Splits a string.
   /*!
     The string is split according to delimiters and elements are stored
-    in the vector 'vect'.
-    \param str string to be split.
+    in the vector 'vect'. The elements already in 'vect' are overwritten,
+    so that their memory is reused: with a vector of strings that is used
+    for several calls, or with a vector of views, no memory is allocated.
+    \param str string to be split. It may be an element of 'vect', in which
+    case it is copied first.
     \param vect (output) vector containing elements of the string.
     \param delimiters (optional) delimiters. Default: " \n\t".
   */
   template <class T>
-  void split(string str, vector<T>& vect, string delimiters)
+  void split(const StringView& str, vector<T>& vect,
+             const StringView& delimiters)
   {
-    vect.clear();
-
-    T tmp;
-    string::size_type index_beg, index_end;
-
-    index_beg = str.find_first_not_of(delimiters);
+    // The elements of 'vect' are overwritten while 'str' is read.
+    if (overlaps(str, vect))
+      {
+        string copy = str.str();
+        split(StringView(copy), vect, delimiters);
+        return;
+      }
 
-    while (index_beg != string::npos)
+    T element;
+    size_t Nelement = 0;
+    SplitView view(str, delimiters);
+    for (SplitIterator i = view.begin(); i != view.end(); ++i, ++Nelement)
       {
-        index_end = str.find_first_of(delimiters, index_beg);
-        convert(str.substr(index_beg, index_end == string::npos ?
-                           string::npos : (index_end - index_beg)), tmp);
-        vect.push_back(tmp);
-        index_beg = str.find_first_not_of(delimiters, index_end);
+        convert_view(*i, element);
+        if (Nelement < vect.size())
+          vect[Nelement] = element;
+        else
+          vect.push_back(element);
       }
+    vect.erase(vect.begin() + Nelement, vect.end());
   }
 
   //! Splits a string.
@@ -515,7 +2457,7 @@ namespace Talos
     \param delimiters (optional) delimiters. Default: " \n\t".
     \return A vector containing elements of the string.
   */
-  vector<string> split(string str, string delimiters)
+  vector<string> split(const string& str, const string& delimiters)
   {
     vector<string> vect;
     split(str, vect, delimiters);
@@ -633,6 +2575,282 @@ namespace Talos
     cout << endl;
   }
 
+
+  //////////////
+  // TEMPLATE //
+  //////////////
+
+
+  //! Default constructor.
+  /*!
+    The template is empty.
+  */
+  Template::Template():
+    markup_tags_("$")
+  {
+  }
+
+  //! Main constructor.
+  /*!
+    \param format the string with markups.
+    \param markup_tags (optional) markup tags. Default: "$".
+  */
+  Template::Template(const string& format, const string& markup_tags)
+  {
+    SetFormat(format, markup_tags);
+  }
+
+  //! Sets the string with markups.
+  /*!
+    The string is split into text and markups as by 'split_markup'. All
+    bindings are cleared.
+    \param format the string with markups.
+    \param markup_tags (optional) markup tags. Default: "$".
+  */
+  void Template::SetFormat(const string& format, const string& markup_tags)
+  {
+    format_ = format;
+    markup_tags_ = markup_tags;
+
+    vector<bool> is_markup;
+    split_markup(format_, element_, is_markup, markup_tags_);
+
+    markup_.clear();
+    markup_index_.assign(element_.size(), -1);
+    for (int i = 0; i < int(element_.size()); i++)
+      if (is_markup[i])
+        {
+          int index = FindMarkup(element_[i]);
+          if (index == -1)
+            {
+              index = int(markup_.size());
+              markup_.push_back(element_[i]);
+            }
+          markup_index_[i] = index;
+        }
+
+    value_.assign(markup_.size(), "");
+    is_bound_.assign(markup_.size(), false);
+  }
+
+  //! Returns the string with markups.
+  /*!
+    \return The string with markups.
+  */
+  const string& Template::GetFormat() const
+  {
+    return format_;
+  }
+
+  //! Returns the markup tags.
+  /*!
+    \return The markup tags.
+  */
+  const string& Template::GetMarkupTags() const
+  {
+    return markup_tags_;
+  }
+
+  //! Returns the number of distinct markups.
+  /*!
+    \return The number of distinct markups.
+  */
+  int Template::GetNmarkup() const
+  {
+    return int(markup_.size());
+  }
+
+  //! Returns the name of a markup.
+  /*!
+    \param i index of the markup, in [0, GetNmarkup()[.
+    \return The name of the markup, without markup tags.
+  */
+  const string& Template::GetMarkup(int i) const
+  {
+    if (i < 0 || i >= int(markup_.size()))
+      throw string("Error in Template::GetMarkup: the index ") + to_str(i)
+        + " is out of range in \"" + format_ + "\".";
+    return markup_[i];
+  }
+
+  //! Checks whether the template contains a given markup.
+  /*!
+    \param name the name of the markup, without markup tags.
+    \return True if the template contains the markup, false otherwise.
+  */
+  bool Template::HasMarkup(const string& name) const
+  {
+    return FindMarkup(name) != -1;
+  }
+
+  //! Binds a value to a markup.
+  /*!
+    \param name the name of the markup, without markup tags.
+    \param value the value.
+    \return True if the template contains the markup, false otherwise (the
+    value is then ignored).
+  */
+  bool Template::Bind(const string& name, const string& value)
+  {
+    int index = FindMarkup(name);
+    if (index == -1)
+      return false;
+    value_[index] = value;
+    is_bound_[index] = true;
+    return true;
+  }
+
+  //! Binds a value to a markup.
+  /*!
+    \param name the name of the markup, without markup tags.
+    \param value the value.
+    \return True if the template contains the markup, false otherwise (the
+    value is then ignored).
+  */
+  bool Template::Bind(const string& name, const char* value)
+  {
+    int index = FindMarkup(name);
+    if (index == -1)
+      return false;
+    value_[index] = value;
+    is_bound_[index] = true;
+    return true;
+  }
+
+  //! Binds a date to a markup.
+  /*!
+    The date is converted as by 'Date::GetDate', in the memory of the
+    previous value.
+    \param name the name of the markup, without markup tags.
+    \param date the date.
+    \param format format of the date (see 'Date::GetDate').
+    \return True if the template contains the markup, false otherwise (the
+    date is then ignored).
+  */
+  bool Template::Bind(const string& name, const Date& date,
+                      const string& format)
+  {
+    int index = FindMarkup(name);
+    if (index == -1)
+      return false;
+    const DateFormat* compiled = DateFormat::Get(format);
+    if (compiled != NULL)
+      compiled->Render(date, value_[index]);
+    else
+      DateFormat(format).Render(date, value_[index]);
+    is_bound_[index] = true;
+    return true;
+  }
+
+  //! Binds a value to a markup.
+  /*!
+    The value is converted with 'to_str'.
+    \param name the name of the markup, without markup tags.
+    \param value the value.
+    \return True if the template contains the markup, false otherwise (the
+    value is then ignored).
+  */
+  template <class T>
+  bool Template::Bind(const string& name, const T& value)
+  {
+    int index = FindMarkup(name);
+    if (index == -1)
+      return false;
+    value_[index] = to_str(value);
+    is_bound_[index] = true;
+    return true;
+  }
+
+  //! Removes the values bound to the markups.
+  void Template::ClearBindings()
+  {
+    is_bound_.assign(markup_.size(), false);
+  }
+
+  //! Replaces the markups with their values.
+  /*!
+    \param output (output) the string with its markups replaced. Its memory
+    is reused.
+    \warning An exception is thrown if a markup has no value.
+  */
+  void Template::Render(string& output) const
+  {
+    output.clear();
+    for (int i = 0; i < int(element_.size()); i++)
+      if (markup_index_[i] == -1)
+        output += element_[i];
+      else if (is_bound_[markup_index_[i]])
+        output += value_[markup_index_[i]];
+      else
+        ThrowUnbound(markup_index_[i]);
+  }
+
+  //! Replaces the markups with their values.
+  /*!
+    \return The string with its markups replaced.
+    \warning An exception is thrown if a markup has no value.
+  */
+  string Template::Render() const
+  {
+    string output;
+    Render(output);
+    return output;
+  }
+
+  //! Replaces the markups with their values, in a buffer.
+  /*!
+    As with 'snprintf', at most 'size' - 1 characters are written, followed
+    by a null character.
+    \param buffer (output) the string with its markups replaced.
+    \param size size of 'buffer'.
+    \return The length of the string with its markups replaced, which may
+    be greater than the number of characters written.
+    \warning An exception is thrown if a markup has no value.
+  */
+  size_t Template::Render(char* buffer, size_t size) const
+  {
+    size_t position = 0;
+    for (int i = 0; i < int(element_.size()); i++)
+      {
+        int index = markup_index_[i];
+        if (index != -1 && !is_bound_[index])
+          ThrowUnbound(index);
+        const string& str = index == -1 ? element_[i] : value_[index];
+        if (position < size)
+          memcpy(buffer + position, str.data(),
+                 min(str.size(), size - position));
+        position += str.size();
+      }
+
+    if (size > 0)
+      buffer[min(position, size - 1)] = '\0';
+    return position;
+  }
+
+  //! Searches for a markup.
+  /*!
+    \param name the name of the markup, without markup tags.
+    \return The index of the markup in 'markup_', or -1 if the template
+    does not contain the markup.
+  */
+  int Template::FindMarkup(const string& name) const
+  {
+    for (int i = 0; i < int(markup_.size()); i++)
+      if (markup_[i] == name)
+        return i;
+    return -1;
+  }
+
+  //! Throws an exception for a markup without value.
+  /*!
+    \param index index of the markup in 'markup_'.
+  */
+  void Template::ThrowUnbound(int index) const
+  {
+    throw string("Error in Template::Render: no value is bound to the")
+      + " markup \"" + markup_[index] + "\" in \"" + format_ + "\".";
+  }
+
 }  // namespace Talos.
 
 
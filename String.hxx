@@ -44,35 +44,194 @@ namespace Talos
   /*!
     It should may be used like that:
     string output = Str() + "There are " + 3 + " laws of robotics.";
+    The characters are appended to a buffer, stored in the object as long as
+    it is short. Strings, characters and numbers are formatted as by an
+    output stream with default flags, but without any stream. Other types
+    are written with their operator <<. Once such an element (possibly a
+    stream manipulator) has been appended, the following elements are all
+    written through a stream that keeps its state, as before. An element
+    added with operator + is written with the default flags.
   */
   class Str
   {
+    template <class T>
+    friend Str operator + (const Str& s, const T& input);
+#ifndef SWIG
+    template <class T>
+    friend Str operator + (Str&& s, const T& input);
+#endif
+
   private:
-    //! Buffer.
-    std::ostringstream output_;
+    //! Characters, as long as they fit.
+    char local_[64];
+    //! Characters: 'local_' or a heap-allocated array.
+    char* data_;
+    //! Number of characters.
+    size_t size_;
+    //! Capacity of 'data_'.
+    size_t capacity_;
+    //! Stream for the elements written with their operator <<, or NULL.
+    ostringstream* stream_;
 
   public:
     Str();
     Str(const Str& s);
+#ifndef SWIG
+    Str(Str&& s);
+#endif
+    ~Str();
+
+#ifndef SWIG
+    Str& operator=(const Str& s);
+    Str& operator=(Str&& s);
+#endif
+
     operator std::string() const;
+    const char* data() const;
+    size_t size() const;
+
     template <class T>
     Str& operator << (const T& input);
+
+  private:
+    void Reserve(size_t size);
+    void Append(const char* str, size_t length);
+    void ResetStream();
+
+    void Write(const string& input);
+    void Write(const char* input);
+    void Write(const Str& input);
+    void Write(char input);
+    void Write(bool input);
+    void Write(int input);
+    void Write(unsigned int input);
+    void Write(long input);
+    void Write(unsigned long input);
+    void Write(long long input);
+    void Write(unsigned long long input);
+    void Write(double input);
+    void Write(float input);
+    template <class T>
+    void Write(const T& input);
   };
 
   template <class T>
   Str operator + (const Str&, const T& input);
+#ifndef SWIG
+  template <class T>
+  Str operator + (Str&& s, const T& input);
+#endif
 
 #ifndef SWIG
-  ostream& operator << (ostream& out, Str& in);
-  ostream& operator << (ostream& out, Str in);
+  //! Non-owning reference to a sequence of characters.
+  /*!
+    The referenced characters must outlive the view. The interface follows
+    that of 'std::string_view'.
+  */
+  class StringView
+  {
+  private:
+    //! First character.
+    const char* data_;
+    //! Number of characters.
+    size_t size_;
+
+  public:
+    StringView();
+    StringView(const char* data, size_t size);
+    StringView(const char* str);
+    StringView(const string& str);
+
+    const char* data() const;
+    size_t size() const;
+    bool empty() const;
+    const char* begin() const;
+    const char* end() const;
+    char operator[] (size_t i) const;
+
+    StringView substr(size_t position, size_t length = string::npos) const;
+    string str() const;
+  };
+
+  bool operator == (const StringView& first, const StringView& second);
+  bool operator != (const StringView& first, const StringView& second);
+  ostream& operator << (ostream& out, const StringView& view);
+
+  class SplitIterator;
+
+  //! Elements of a string separated by delimiters, as a range of views.
+  /*!
+    It should be used like that:
+    for (StringView element : SplitView(line, " \t"))
+      ...
+    The elements are the non-empty sequences of characters without
+    delimiters. They are views of the string, which must outlive the range.
+    No memory is allocated. With a single delimiter, the elements are found
+    with 'memchr'.
+  */
+  class SplitView
+  {
+    friend class SplitIterator;
+
+  private:
+    //! String to be split.
+    StringView str_;
+    //! Number of delimiters.
+    size_t Ndelimiter_;
+    //! The delimiter, if there is only one.
+    char delimiter_;
+    //! Is a character a delimiter? Only used with several delimiters.
+    bool is_delimiter_[256];
+
+  public:
+    SplitView(const StringView& str, const StringView& delimiters = " \n\t");
+
+    SplitIterator begin() const;
+    SplitIterator end() const;
+
+  private:
+    bool IsDelimiter(char c) const;
+    const char* SkipDelimiters(const char* position) const;
+    const char* FindDelimiter(const char* position) const;
+  };
+
+  //! Forward iterator over the elements of a 'SplitView'.
+  class SplitIterator
+  {
+  private:
+    //! The split string.
+    const SplitView* split_;
+    //! Current element. It is empty at the end of the string.
+    StringView element_;
+
+  public:
+    SplitIterator();
+    SplitIterator(const SplitView& split, const char* position);
+
+    const StringView& operator* () const;
+    const StringView* operator-> () const;
+    SplitIterator& operator++ ();
+    SplitIterator operator++ (int);
+
+    bool operator == (const SplitIterator& iterator) const;
+    bool operator != (const SplitIterator& iterator) const;
+  };
+#endif
+
+#ifndef SWIG
+  ostream& operator << (ostream& out, const Str& in);
 #endif
 
   template<typename T>
   string to_str(const T& input);
+  string to_str_shortest(double input);
 
 #ifndef SWIG
   string fill(const string& input, int l = 2, char c = ' ',
               ostringstream::fmtflags flags = ostringstream::left);
+  size_t fill(const char* input, size_t length, char* buffer, size_t size,
+              int l = 2, char c = ' ',
+              ostringstream::fmtflags flags = ostringstream::left);
 
   template<typename T>
   string to_str_fill(const T& input, int l = 2, char c = ' ',
@@ -80,10 +239,15 @@ namespace Talos
 #endif
 
   template <class T>
-  void to_num(const string& s, T& num);
+  void to_num(const string& s, T& num, bool strict = false);
 
   template <class T>
-  T to_num(const string& s);
+  T to_num(const string& s, bool strict = false);
+
+#ifndef SWIG
+  template <class T>
+  bool to_num(const char* begin, const char* end, T& num);
+#endif
 
   template <class T>
   void convert(const string& s, T& num);
@@ -92,10 +256,22 @@ namespace Talos
   template <class T>
   T convert(const string& s);
 
+#ifndef SWIG
+  template <class T>
+  const char* parse_num(const char* begin, const char* end, T& num);
+#endif
+
   string lower_case(string str);
   string upper_case(string str);
 
   bool is_num(const string& s);
+#ifndef SWIG
+  bool is_num(const char* begin, const char* end);
+  template <class T>
+  bool is_num(const string& s, T& num);
+  template <class T>
+  bool is_num(const char* begin, const char* end, T& num);
+#endif
 
   // The functions with 'char*' and 'const char*' are provided for convenience
   // and to adequately overload the function 'is_integer' of the scientific
@@ -103,6 +279,9 @@ namespace Talos
   bool is_integer(char* s);
   bool is_integer(const char* s);
   bool is_integer(const string& s);
+#ifndef SWIG
+  bool is_integer(const char* begin, const char* end);
+#endif
 
   bool is_unsigned_integer(const string& s);
 
@@ -118,14 +297,76 @@ namespace Talos
 
   string trim_end(string str, string delimiters = " \n\t");
 
+#ifndef SWIG
   template <class T>
-  void split(string str, vector<T>& vect, string delimiters = " \n\t");
-  vector<string> split(string str, string delimiters = " \n\t");
+  void split(const StringView& str, vector<T>& vect,
+             const StringView& delimiters = " \n\t");
+#endif
+  vector<string> split(const string& str, const string& delimiters = " \n\t");
 
   template <class T>
   void split_markup(string str, vector<T>& elements, vector<bool>& is_markup,
                     string delimiters = "$");
 
+  //! String with markups, compiled once and rendered many times.
+  /*!
+    A markup is a name delimited by two markup tags, e.g. "$Date$". The
+    string is split into text and markups once, as by 'split_markup'. Values
+    (strings, numbers or dates) are then bound to the markups, and the
+    string is rendered without being parsed again, into a string whose
+    memory is reused or into a buffer. It should be used like that:
+    Template path("results/$Species$_$Date$.bin");
+    path.Bind("Species", "O3");
+    path.Bind("Date", date, "%y%m%d");
+    path.Render(file_name);
+  */
+  class Template
+  {
+  private:
+    //! String with markups.
+    string format_;
+    //! Markup tags.
+    string markup_tags_;
+    //! Text and markups, in order, without the markup tags.
+    vector<string> element_;
+    //! Index in 'markup_' of each element, or -1 if the element is text.
+    vector<int> markup_index_;
+    //! Names of the markups, without duplicates.
+    vector<string> markup_;
+    //! Values bound to the markups.
+    vector<string> value_;
+    //! Is a value bound to each markup?
+    vector<bool> is_bound_;
+
+  public:
+    Template();
+    Template(const string& format, const string& markup_tags = "$");
+
+    void SetFormat(const string& format, const string& markup_tags = "$");
+    const string& GetFormat() const;
+    const string& GetMarkupTags() const;
+    int GetNmarkup() const;
+    const string& GetMarkup(int i) const;
+    bool HasMarkup(const string& name) const;
+
+    bool Bind(const string& name, const string& value);
+    bool Bind(const string& name, const char* value);
+    bool Bind(const string& name, const Date& date, const string& format);
+    template <class T>
+    bool Bind(const string& name, const T& value);
+    void ClearBindings();
+
+    void Render(string& output) const;
+    string Render() const;
+#ifndef SWIG
+    size_t Render(char* buffer, size_t size) const;
+#endif
+
+  private:
+    int FindMarkup(const string& name) const;
+    void ThrowUnbound(int index) const;
+  };
+
   template <class T>
   void print(const vector<T>& v);
 
@@ -0,0 +1,179 @@
+// Copyright (C) 2004-2007, INRIA
+// Author(s): Vivien Mallet
+//
+// This file is part of Talos library, which provides miscellaneous tools to
+// make up for C++ lacks and to ease C++ programming.
+//
+// Talos is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Talos is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Talos. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Talos home page:
+//     http://vivienmallet.net/lib/talos/
+
+
+// Benchmark of the differences of dates, the week days and the sorting of
+// dates against the year-by-year loops of Talos 1.4, for increasing spans of
+// years. Compile with:
+//     g++ -std=c++11 -O2 -I.. bench_date.cpp -o bench_date
+// The program prints the timings and returns 0 if both methods gave the
+// same results.
+
+
+#include "Talos.hxx"
+using namespace Talos;
+
+#include <chrono>
+#include <cstdlib>
+
+
+//! Returns the time elapsed since a given instant, in seconds.
+double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                       - start).count();
+}
+
+
+//! Date whose differences are computed with loops, as in Talos 1.4.
+class LoopDate
+{
+public:
+  int year_;
+  int month_;
+  int day_;
+
+  LoopDate(int yyyy, int mm, int dd): year_(yyyy), month_(mm), day_(dd)
+  {
+  }
+
+  static bool LeapYear(int year)
+  {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+  }
+
+  int GetNumberOfDays() const
+  {
+    static const int length[12] = {31, 28, 31, 30, 31, 30,
+                                   31, 31, 30, 31, 30, 31};
+    int res(0);
+    for (int i = 1; i < month_; i++)
+      res += i == 2 && LeapYear(year_) ? 29 : length[i - 1];
+    return res + day_ - 1;
+  }
+
+  int GetDaysFrom(const LoopDate& date) const
+  {
+    int min_year = min(year_, date.year_);
+    int nb_days(0), nb_days_date(0);
+    for (int i = min_year; i < year_; i++)
+      nb_days += LeapYear(i) ? 366 : 365;
+    nb_days += GetNumberOfDays();
+    for (int i = min_year; i < date.year_; i++)
+      nb_days_date += LeapYear(i) ? 366 : 365;
+    nb_days_date += date.GetNumberOfDays();
+    return nb_days - nb_days_date;
+  }
+
+  int GetWeekDay() const
+  {
+    int day = 0;
+    for (int year = 1900; year < year_; year++)
+      day += LeapYear(year) ? 366 : 365;
+    day += GetNumberOfDays();
+    return day % 7;
+  }
+};
+
+
+bool operator < (const LoopDate& first_date, const LoopDate& second_date)
+{
+  return first_date.GetDaysFrom(second_date) < 0;
+}
+
+
+//! Benchmarks dates spread over a given number of years after 1900.
+/*!
+  \param Nyear number of years.
+  \param N number of dates.
+  \return true if both methods gave the same results, false otherwise.
+*/
+bool benchmark(int Nyear, int N)
+{
+  srand(Nyear);
+  vector<LoopDate> loop_date;
+  vector<Date> date;
+  for (int i = 0; i < N; i++)
+    {
+      int year = 1900 + rand() % Nyear;
+      int month = 1 + rand() % 12;
+      int day = 1 + rand() % 28;
+      loop_date.push_back(LoopDate(year, month, day));
+      date.push_back(Date(year, month, day));
+    }
+
+  std::chrono::steady_clock::time_point start;
+  double loop_time, time;
+  long long loop_sum = 0, sum = 0;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 1; i < N; i++)
+    loop_sum += loop_date[i].GetDaysFrom(loop_date[i - 1])
+      + loop_date[i].GetWeekDay();
+  loop_time = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 1; i < N; i++)
+    sum += date[i].GetDaysFrom(date[i - 1]) + date[i].GetWeekDay();
+  time = elapsed(start);
+
+  cout << to_str_fill(Nyear, 5, ' ', ostringstream::right) << " years:"
+       << " differences and week days " << loop_time << " s -> " << time
+       << " s,";
+
+  start = std::chrono::steady_clock::now();
+  sort(loop_date.begin(), loop_date.end());
+  loop_time = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  sort(date.begin(), date.end());
+  time = elapsed(start);
+
+  cout << " sorting " << loop_time << " s -> " << time << " s" << endl;
+
+  bool same = loop_sum == sum;
+  for (int i = 0; i < N; i++)
+    same = same && loop_date[i].year_ == date[i].GetYear()
+      && loop_date[i].month_ == date[i].GetMonth()
+      && loop_date[i].day_ == date[i].GetDay();
+  return same;
+}
+
+
+int main()
+{
+  int Nfailure = 0;
+
+  TRY;
+
+  const int Nyear[4] = {10, 100, 200, 1000};
+  for (int i = 0; i < 4; i++)
+    if (!benchmark(Nyear[i], 200000))
+      {
+        cout << "Failed: benchmark (" << Nyear[i] << " years)" << endl;
+        Nfailure++;
+      }
+
+  END;
+
+  return Nfailure == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+// Copyright (C) 2004-2007, INRIA
+// Author(s): Vivien Mallet
+//
+// This file is part of Talos library, which provides miscellaneous tools to
+// make up for C++ lacks and to ease C++ programming.
+//
+// Talos is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Talos is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Talos. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Talos home page:
+//     http://vivienmallet.net/lib/talos/
+
+
+// Benchmark of 'ExtStream::GetNumbers' against reading the numbers one by
+// one, with a string per element converted by a stream as in Talos 1.4, and
+// with 'GetNumber'. Compile with:
+//     g++ -std=c++11 -O2 -I.. bench_numbers.cpp -o bench_numbers
+// and run in a writable directory. The program prints the timings and
+// returns 0 if all the methods read the same numbers.
+
+
+#include "Talos.hxx"
+using namespace Talos;
+
+#include <chrono>
+#include <cstdlib>
+
+
+//! Returns the time elapsed since a given instant, in seconds.
+double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                       - start).count();
+}
+
+
+int main()
+{
+  const size_t N = 1000000;
+  const string file_name = "bench_numbers.dat";
+
+  // Numbers with a few digits, as written by a model, and a few integers.
+  srand(1);
+  {
+    ofstream output(file_name.c_str());
+    for (size_t i = 0; i < N; i++)
+      if (i % 10 == 0)
+        output << rand() % 1000 << (i % 8 == 7 ? "\n" : " ");
+      else
+        output << double(rand() % 2000000 - 1000000) / 1000.
+               << (i % 8 == 7 ? "\n" : " ");
+  }
+
+  vector<double> reference(N), single(N), numbers(N);
+  std::chrono::steady_clock::time_point start;
+
+  TRY;
+
+  // As in Talos 1.4.
+  ExtStream stream(file_name);
+  start = std::chrono::steady_clock::now();
+  string element;
+  for (size_t i = 0; i < N; i++)
+    {
+      stream.GetElement(element);
+      istringstream str(element);
+      str >> reference[i];
+    }
+  cout << "Element and stream: " << elapsed(start) << " s" << endl;
+
+  stream.Rewind();
+  start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < N; i++)
+    stream.GetNumber(single[i]);
+  cout << "GetNumber:          " << elapsed(start) << " s" << endl;
+
+  stream.Rewind();
+  start = std::chrono::steady_clock::now();
+  stream.GetNumbers(numbers);
+  cout << "GetNumbers:         " << elapsed(start) << " s" << endl;
+
+  END;
+
+  std::remove(file_name.c_str());
+
+  if (single != reference || numbers != reference)
+    {
+      cout << "Failed: the numbers differ." << endl;
+      return 1;
+    }
+
+  return 0;
+}
@@ -0,0 +1,159 @@
+// Copyright (C) 2004-2007, INRIA
+// Author(s): Vivien Mallet
+//
+// This file is part of Talos library, which provides miscellaneous tools to
+// make up for C++ lacks and to ease C++ programming.
+//
+// Talos is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Talos is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Talos. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Talos home page:
+//     http://vivienmallet.net/lib/talos/
+
+
+// Benchmark of 'Str' against the stream-based 'Str' of Talos 1.4, on short
+// messages and on long chains of additions. Compile with:
+//     g++ -std=c++11 -O2 -I.. bench_str.cpp -o bench_str
+// The program prints the timings and returns 0 if both classes built the
+// same strings.
+
+
+#include "Talos.hxx"
+using namespace Talos;
+
+#include <chrono>
+
+
+//! Returns the time elapsed since a given instant, in seconds.
+double elapsed(const std::chrono::steady_clock::time_point& start)
+{
+  return std::chrono::duration<double>(std::chrono::steady_clock::now()
+                                       - start).count();
+}
+
+
+//! String builder of Talos 1.4, with a copy constructor that terminates.
+class StreamStr
+{
+private:
+  ostringstream output_;
+
+public:
+  StreamStr()
+  {
+  }
+
+  StreamStr(const StreamStr& s)
+  {
+    output_ << s.output_.str();
+  }
+
+  operator std::string() const
+  {
+    return output_.str();
+  }
+
+  template <class T>
+  StreamStr& operator << (const T& input)
+  {
+    output_ << input;
+    return *this;
+  }
+};
+
+
+//! Every addition copies the accumulated string, as in Talos 1.4.
+template <class T>
+StreamStr operator + (const StreamStr& s, const T& input)
+{
+  string s_input = s;
+  StreamStr output;
+  output << s_input << input;
+  return output;
+}
+
+
+//! Builds a short message.
+template <class S>
+string message(int i, double x)
+{
+  return S() + "Error in Function: element #" + i + " (" + x
+    + ") is not in [" + 0 + ", " + 1.5 + "].";
+}
+
+
+//! Builds a long line with a single chain of additions.
+template <class S>
+string line(int i, double x)
+{
+  return S() + i + ' ' + x + ' ' + i + ' ' + x + ' ' + i + ' ' + x + ' '
+    + i + ' ' + x + ' ' + i + ' ' + x + ' ' + i + ' ' + x + ' ' + i + ' '
+    + x + ' ' + i + ' ' + x + ' ' + i + ' ' + x + ' ' + i + ' ' + x + ' '
+    + i + ' ' + x + ' ' + i + ' ' + x + ' ' + i + ' ' + x + ' ' + i + ' '
+    + x + ' ' + i + ' ' + x + ' ' + i + ' ' + x + '\n';
+}
+
+
+//! Benchmarks a function with both classes.
+/*!
+  \param name name of the benchmark.
+  \param reference the function with 'StreamStr'.
+  \param function the function with 'Str'.
+  \param N number of calls.
+  \return true if both functions built the same strings, false otherwise.
+*/
+bool benchmark(const string& name, string (*reference)(int, double),
+               string (*function)(int, double), int N)
+{
+  vector<string> reference_output(N), output(N);
+  std::chrono::steady_clock::time_point start;
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++)
+    reference_output[i] = reference(i, double(i) / 7.);
+  double reference_time = elapsed(start);
+
+  start = std::chrono::steady_clock::now();
+  for (int i = 0; i < N; i++)
+    output[i] = function(i, double(i) / 7.);
+  double time = elapsed(start);
+
+  cout << name << ": " << reference_time << " s -> " << time << " s"
+       << endl;
+
+  return output == reference_output;
+}
+
+
+int main()
+{
+  int Nfailure = 0;
+
+  TRY;
+
+  if (!benchmark("Short messages", message<StreamStr>, message<Str>, 200000))
+    {
+      cout << "Failed: short messages" << endl;
+      Nfailure++;
+    }
+
+  if (!benchmark("Long chains   ", line<StreamStr>, line<Str>, 20000))
+    {
+      cout << "Failed: long chains" << endl;
+      Nfailure++;
+    }
+
+  END;
+
+  return Nfailure == 0 ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+// Copyright (C) 2004-2007, INRIA
+// Author(s): Vivien Mallet
+//
+// This file is part of Talos library, which provides miscellaneous tools to
+// make up for C++ lacks and to ease C++ programming.
+//
+// Talos is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Talos is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Talos. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Talos home page:
+//     http://vivienmallet.net/lib/talos/
+
+
+// Regression tests for 'ConfigStream' and 'ConfigStreams'. Compile with:
+//     g++ -std=c++11 -I.. config_streams.cpp -o config_streams
+// and run in a writable directory. The program returns 0 on success. Do not
+// define 'TALOS_DEBUG': the configuration files are removed before the end
+// of the program, when the debug mode reads them again.
+
+
+#include "Talos.hxx"
+using namespace Talos;
+
+
+//! A section that runs off the end of a file continues in the next file.
+/*!
+  The next file must be read from its beginning, even if a previous search
+  left it in the middle.
+  \return true if the test passed, false otherwise.
+*/
+bool test_section_continues_in_next_file()
+{
+  ofstream("config_streams_a.cfg") << "[s1]\nDirectory: /tmp/dir0\n";
+  ofstream("config_streams_b.cfg") << "a hello yes\nx = yes\n";
+
+  ConfigStreams config("config_streams_a.cfg", "config_streams_b.cfg");
+  config.FindFromBeginning("x");
+  config.SetSection("[s1]");
+  string value = config.GetValue("a");
+
+  std::remove("config_streams_a.cfg");
+  std::remove("config_streams_b.cfg");
+
+  return value == "hello";
+}
+
+
+//! A line that ends the file leaves the stream failed, without 'eofbit'.
+/*!
+  The last line may or may not end with a newline, and it may contain a
+  markup.
+  \return true if the test passed, false otherwise.
+*/
+bool test_get_line_state()
+{
+  ofstream("config_streams_a.cfg") << "a = 1\nb = $a$ x";
+  ofstream("config_streams_b.cfg") << "a = 1\nb = 2\n";
+
+  ConfigStream without_newline("config_streams_a.cfg");
+  string first, last;
+  without_newline.GetLine(first);
+  bool success = without_newline.GetLine(last);
+  bool passed = first == "a = 1" && last == "b = 1 x" && success
+    && without_newline.fail() && !without_newline.eof();
+
+  ConfigStream with_newline("config_streams_b.cfg");
+  with_newline.GetLine();
+  last = with_newline.GetLine();
+  passed = passed && last == "b = 2" && with_newline.good();
+  success = with_newline.GetLine(last);
+  passed = passed && !success && with_newline.fail()
+    && !with_newline.eof();
+
+  std::remove("config_streams_a.cfg");
+  std::remove("config_streams_b.cfg");
+
+  return passed;
+}
+
+
+//! A mapped file truncated by another process is read through the buffer.
+/*!
+  The file is truncated in place after it has been mapped. Once rewound,
+  the stream must read the new contents instead of the lost pages.
+  \return true if the test passed, false otherwise.
+*/
+bool test_rewind_truncated_file()
+{
+  {
+    ofstream file("config_streams_a.cfg");
+    for (int i = 0; i < 10000; i++)
+      file << "field_" << i << " = " << i << "\n";
+  }
+
+  ConfigStream config("config_streams_a.cfg");
+  string first = config.GetElement();
+  ofstream("config_streams_a.cfg") << "x = 1\n";
+  config.Rewind();
+  string line = config.GetLine();
+  bool passed = first == "field_0" && line == "x = 1"
+    && config.GetElement() == "" && !config.IsMapped();
+
+  std::remove("config_streams_a.cfg");
+
+  return passed;
+}
+
+
+int main()
+{
+  int Nfailure = 0;
+
+  TRY;
+
+  if (!test_section_continues_in_next_file())
+    {
+      cout << "Failed: test_section_continues_in_next_file" << endl;
+      Nfailure++;
+    }
+
+  if (!test_get_line_state())
+    {
+      cout << "Failed: test_get_line_state" << endl;
+      Nfailure++;
+    }
+
+  if (!test_rewind_truncated_file())
+    {
+      cout << "Failed: test_rewind_truncated_file" << endl;
+      Nfailure++;
+    }
+
+  END;
+
+  return Nfailure == 0 ? 0 : 1;
+}
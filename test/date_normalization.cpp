@@ -0,0 +1,288 @@
+// Copyright (C) 2004-2007, INRIA
+// Author(s): Vivien Mallet
+//
+// This file is part of Talos library, which provides miscellaneous tools to
+// make up for C++ lacks and to ease C++ programming.
+//
+// Talos is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Talos is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Talos. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Talos home page:
+//     http://vivienmallet.net/lib/talos/
+
+
+// Randomized equivalence test of the normalization of 'Date' against the
+// step-by-step normalization of Talos 1.4. Compile with:
+//     g++ -std=c++11 -I.. date_normalization.cpp -o date_normalization
+// The program returns 0 on success.
+
+
+#include "Talos.hxx"
+using namespace Talos;
+
+#include <cstdlib>
+
+
+//! Date normalized step by step, as in Talos 1.4.
+/*!
+  The carries are those of 'Date::Adjust' in Talos 1.4, which walks the
+  days month by month, with the two bugs of 1.4 fixed: months that are a
+  multiple of 12 above 12, and hours that are a negative multiple of 24.
+*/
+class StepDate
+{
+public:
+  int year_;
+  int month_;
+  int day_;
+  int hour_;
+  int minutes_;
+  double seconds_;
+
+  StepDate(int yyyy, int mm, int dd, int hh, int mn, double sc):
+    year_(yyyy), month_(mm), day_(dd), hour_(hh), minutes_(mn), seconds_(sc)
+  {
+  }
+
+  int MonthLength(int month) const
+  {
+    static const int length[12] = {31, 28, 31, 30, 31, 30,
+                                   31, 31, 30, 31, 30, 31};
+    bool leap = (year_ % 4 == 0 && year_ % 100 != 0) || year_ % 400 == 0;
+    return month == 2 && leap ? 29 : length[month - 1];
+  }
+
+  void Adjust()
+  {
+    // Minutes.
+    if (seconds_ >= 60.)
+      {
+        minutes_ += int(seconds_ / 60.);
+        seconds_ -= double(int(seconds_ / 60.)) * 60.;
+      }
+    if (seconds_ < 0.)
+      {
+        minutes_ += int(seconds_ / 60.) - 1;
+        seconds_ -= double(int(seconds_ / 60.) - 1) * 60.;
+        if (seconds_ == 60.)
+          {
+            minutes_ += 1;
+            seconds_ = 0.;
+          }
+      }
+
+    // Hours.
+    if (minutes_ > 59)
+      {
+        hour_ += minutes_ / 60;
+        minutes_ = minutes_ % 60;
+      }
+    else if (minutes_ < 0)
+      {
+        hour_ += (minutes_ + 1) / 60 - 1;
+        minutes_ = 59 + (minutes_ + 1) % 60;
+      }
+
+    // Days.
+    if (hour_ > 23)
+      {
+        day_ += hour_ / 24;
+        hour_ = hour_ % 24;
+      }
+    else if (hour_ < 0)
+      {
+        day_ += (hour_ + 1) / 24 - 1;
+        hour_ = 23 + (hour_ + 1) % 24;
+      }
+
+    // Months.
+    if (month_ > 12)
+      {
+        year_ += (month_ - 1) / 12;
+        month_ = (month_ - 1) % 12 + 1;
+      }
+    else if (month_ <= 0)
+      {
+        year_ += month_ / 12 - 1;
+        month_ = 12 + month_ % 12;
+      }
+
+    // Months again.
+    while (day_ > MonthLength(month_))
+      {
+        day_ -= MonthLength(month_);
+        if (++month_ == 13)
+          {
+            month_ = 1;
+            ++year_;
+          }
+      }
+    while (day_ <= 0)
+      {
+        if (--month_ == 0)
+          {
+            month_ = 12;
+            --year_;
+          }
+        day_ += MonthLength(month_);
+      }
+  }
+};
+
+
+//! Returns a random integer in [-magnitude, magnitude].
+int random_offset(int magnitude)
+{
+  return int(rand() % (2 * (long long) magnitude + 1) - magnitude);
+}
+
+
+//! Returns a random magnitude, from a few units to large offsets.
+int random_magnitude()
+{
+  static const int magnitude[5] = {3, 40, 1000, 100000, 10000000};
+  return magnitude[rand() % 5];
+}
+
+
+//! Applies random operations to a date and to its step-by-step reference.
+/*!
+  \param seed seed of the random generator.
+  \param Noperation number of operations.
+  \return true if both dates remained equal, false otherwise.
+*/
+bool test_sequence(unsigned int seed, int Noperation)
+{
+  srand(seed);
+
+  // Start at a month end, possibly a 29th of February, in half the cases.
+  int year = 1800 + rand() % 400;
+  int month = 1 + rand() % 12;
+  StepDate reference(year, month, 1, rand() % 24, rand() % 60,
+                     double(rand() % 120) / 2.);
+  reference.day_ = rand() % 2 == 0 ? reference.MonthLength(month)
+    : 1 + rand() % reference.MonthLength(month);
+  Date date(year, month, reference.day_, reference.hour_,
+            reference.minutes_, reference.seconds_);
+
+  for (int i = 0; i < Noperation; i++)
+    {
+      int operation = rand() % 9;
+      int magnitude = random_magnitude();
+      int offset;
+      string name;
+      switch (operation)
+        {
+        case 0:
+          // Up to about 300 years.
+          offset = random_offset(min(magnitude, 100000));
+          date.AddDays(offset);
+          reference.day_ += offset;
+          name = "AddDays";
+          break;
+        case 1:
+          offset = random_offset(min(magnitude, 2000000));
+          date.AddHours(offset);
+          reference.hour_ += offset;
+          name = "AddHours";
+          break;
+        case 2:
+          offset = random_offset(magnitude);
+          date.AddMinutes(offset);
+          reference.minutes_ += offset;
+          name = "AddMinutes";
+          break;
+        case 3:
+          offset = random_offset(magnitude);
+          date.AddSeconds(double(offset) / 2.);
+          reference.seconds_ += double(offset) / 2.;
+          name = "AddSeconds";
+          break;
+        case 4:
+          offset = random_offset(min(magnitude, 3000));
+          date.AddMonths(offset);
+          reference.month_ += offset;
+          name = "AddMonths";
+          break;
+        case 5:
+          offset = random_offset(40);
+          date.SetDay(offset);
+          reference.day_ = offset;
+          name = "SetDay";
+          break;
+        case 6:
+          offset = random_offset(30);
+          date.SetMonth(offset);
+          reference.month_ = offset;
+          name = "SetMonth";
+          break;
+        case 7:
+          offset = random_offset(100);
+          date.SetHour(offset);
+          reference.hour_ = offset;
+          name = "SetHour";
+          break;
+        default:
+          offset = random_offset(200);
+          date.SetMinutes(offset);
+          reference.minutes_ = offset;
+          name = "SetMinutes";
+        }
+      reference.Adjust();
+
+      // Keeps the years in a range where both are defined.
+      if (reference.year_ < 100 || reference.year_ > 9000)
+        {
+          date.SetDate(year, month, 1);
+          reference = StepDate(year, month, 1, 0, 0, 0.);
+        }
+
+      if (date.GetYear() != reference.year_
+          || date.GetMonth() != reference.month_
+          || date.GetDay() != reference.day_
+          || date.GetHour() != reference.hour_
+          || date.GetMinutes() != reference.minutes_
+          || date.GetSeconds() != reference.seconds_)
+        {
+          cout << "Seed " << seed << ", operation " << i << ": " << name
+               << "(" << offset << ") gave "
+               << date.GetDate("%y-%m-%d %h:%i:%s") << " instead of "
+               << reference.year_ << "-" << reference.month_ << "-"
+               << reference.day_ << " "
+               << reference.hour_ << ":" << reference.minutes_ << ":"
+               << reference.seconds_ << "." << endl;
+          return false;
+        }
+    }
+
+  return true;
+}
+
+
+int main()
+{
+  int Nfailure = 0;
+
+  TRY;
+
+  for (unsigned int seed = 1; seed <= 2000; seed++)
+    if (!test_sequence(seed, 60))
+      Nfailure++;
+
+  if (Nfailure != 0)
+    cout << "Failed: test_sequence (" << Nfailure << " seeds)" << endl;
+
+  END;
+
+  return Nfailure == 0 ? 0 : 1;
+}
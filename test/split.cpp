@@ -0,0 +1,81 @@
+// Copyright (C) 2004-2007, INRIA
+// Author(s): Vivien Mallet
+//
+// This file is part of Talos library, which provides miscellaneous tools to
+// make up for C++ lacks and to ease C++ programming.
+//
+// Talos is free software; you can redistribute it and/or modify it under the
+// terms of the GNU Lesser General Public License as published by the Free
+// Software Foundation; either version 2.1 of the License, or (at your option)
+// any later version.
+//
+// Talos is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public License for
+// more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with Talos. If not, see http://www.gnu.org/licenses/.
+//
+// For more information, visit the Talos home page:
+//     http://vivienmallet.net/lib/talos/
+
+
+// Regression tests for 'split'. Compile with:
+//     g++ -std=c++11 -I.. split.cpp -o split
+// The program returns 0 on success.
+
+
+#include "Talos.hxx"
+using namespace Talos;
+
+
+//! A string can be split into the vector it belongs to.
+/*!
+  The elements of the vector are overwritten, and the vector may be
+  reallocated, while the string is split.
+  \return true if the test passed, false otherwise.
+*/
+bool test_split_into_own_vector()
+{
+  // A short string, stored in the vector, that is moved when the vector
+  // grows.
+  vector<string> short_vect(1, "a b");
+  short_vect.shrink_to_fit();
+  split(short_vect[0], short_vect);
+  if (short_vect.size() != 2 || short_vect[0] != "a"
+      || short_vect[1] != "b")
+    return false;
+
+  // A long string, whose characters are overwritten by the first element.
+  string line = "first_element_longer_than_any_inline_buffer second third";
+  vector<string> long_vect(3, line);
+  split(long_vect[1], long_vect);
+  if (long_vect.size() != 3 || long_vect[0] != "first_element_longer_than"
+      "_any_inline_buffer" || long_vect[1] != "second"
+      || long_vect[2] != "third")
+    return false;
+
+  // A view into an element of the vector.
+  vector<string> view_vect(1, "x,y,z");
+  split(StringView(view_vect[0]).substr(2), view_vect, ",");
+  return view_vect.size() == 2 && view_vect[0] == "y" && view_vect[1] == "z";
+}
+
+
+int main()
+{
+  int Nfailure = 0;
+
+  TRY;
+
+  if (!test_split_into_own_vector())
+    {
+      cout << "Failed: test_split_into_own_vector" << endl;
+      Nfailure++;
+    }
+
+  END;
+
+  return Nfailure == 0 ? 0 : 1;
+}